@@ -1,25 +1,40 @@
 #include <benchmark/benchmark.h>
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
 #include <fstream>
 #include <iostream>
-#include <sstream>
+#include <iterator>
+#include <mutex>
+#include <thread>
 
+#include "parsemd/binary.h"
+#include "parsemd/blockreader.h"
+#include "parsemd/cursor.h"
+#include "parsemd/diff.h"
+#include "parsemd/document.h"
+#include "parsemd/flattree.h"
+#include "parsemd/html.h"
+#include "parsemd/json.h"
+#include "parsemd/mappedfile.h"
+#include "parsemd/node.h"
+#include "parsemd/padded.h"
 #include "parsemd/parser.h"
 
 using namespace std;
 
-static std::string md_content, md_100KB, md_1MB;
+static markdown::MappedFile md_file;
+static std::string_view md_content, md_100KB, md_1MB;
 static markdown::Parser p;
+static markdown::CommonMarkParser cmp;
 
 static void LoadFileOnce() {
-  std::ifstream fs("data.md");
-  if (!fs) {
+  if (!md_file.Open("data.md", true)) {
     throw std::runtime_error(
         "data.md not found. Please execute `randomData.py` to generate "
         "data.md");
   }
-  std::ostringstream ss;
-  ss << fs.rdbuf();
-  md_content = ss.str();
+  md_content = md_file.View();
   md_100KB = md_content.substr(0, 100 * 1024);
   md_1MB = md_content.substr(0, 1024 * 1024);
 }
@@ -36,6 +51,378 @@ static void BM_Parse100KB(benchmark::State& state) {
   }
 }
 
+// Without the copy, once with the unchecked routines of padded input
+static void BM_ParsePadded1MB(benchmark::State& state) {
+  markdown::PaddedString doc(md_1MB);
+  for (auto _ : state) {
+    p.Parse(doc);
+  }
+}
+
+static void BM_ParseBorrowed1MB(benchmark::State& state) {
+  for (auto _ : state) {
+    p.BorrowDocument(md_1MB);
+    p.Parse();
+  }
+}
+
+// Everything from one arena, released in one go after every parse
+static void BM_ParseMonotonic1MB(benchmark::State& state) {
+  std::pmr::monotonic_buffer_resource resource;
+  for (auto _ : state) {
+    {
+      markdown::Parser parser(&resource);
+      benchmark::DoNotOptimize(parser.Parse(md_1MB));
+    }
+    resource.release();
+  }
+  state.SetBytesProcessed(state.iterations() * md_1MB.size());
+}
+
+// Documents of a service: mostly a few KB, now and then a large one. Cut from
+// data.md at line starts, spread over the file.
+static std::vector<std::string_view> MakeDocumentMix() {
+  const size_t sizes[] = {1 << 10, 2 << 10,  4 << 10,   8 << 10,  16 << 10,
+                          1 << 10, 2 << 10,  4 << 10,   8 << 10,  16 << 10,
+                          1 << 10, 2 << 10,  4 << 10,   8 << 10,  16 << 10,
+                          64 << 10, 128 << 10, 256 << 10, 512 << 10, 1 << 20};
+  std::vector<std::string_view> mix;
+  for (size_t i = 0; i < std::size(sizes); i++) {
+    size_t size = std::min(sizes[i], md_content.size());
+    size_t begin = (i * 7919 << 10) % (md_content.size() - size + 1);
+    begin = md_content.rfind('\n', begin);
+    begin = begin == std::string_view::npos ? 0 : begin + 1;
+    mix.push_back(md_content.substr(begin, size));
+  }
+  return mix;
+}
+
+// Per-document latencies of every thread of a run. The last thread to hand
+// in its own reports the percentiles over all of them.
+class Latencies {
+ public:
+  void Report(benchmark::State& state, const std::vector<int64_t>& nanos) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    all_.insert(all_.end(), nanos.begin(), nanos.end());
+    if (++threads_ < state.threads() || all_.empty()) {
+      return;
+    }
+    const std::pair<const char*, double> percentiles[] = {
+        {"p50 us", 0.5}, {"p99 us", 0.99}, {"p999 us", 0.999}};
+    for (auto [name, p] : percentiles) {
+      auto it = all_.begin() + std::min<size_t>(p * all_.size(),
+                                                all_.size() - 1);
+      std::nth_element(all_.begin(), it, all_.end());
+      state.counters[name] = *it / 1e3;
+    }
+    all_.clear();
+    threads_ = 0;
+  }
+
+ protected:
+  std::mutex mutex_;
+  std::vector<int64_t> all_;
+  int threads_ = 0;
+};
+
+// state.threads() threads, each with its own parser, parse the document mix
+// from different starting points. Bytes are summed over the threads and the
+// time is wall time, so the rate is the aggregate MB/s. A parse is timed up
+// to the release of its tree, where a shared allocator shows up as well. The
+// Arena variant gives every thread a pool over an arena of its own instead:
+// trees go back to the pool, and the arena only returns memory to the heap
+// once the thread is done. A first pass over the mix warms the parser, so
+// the pool has all its memory by the time parses are timed.
+template <bool Arena>
+static void BM_ParseThreads(benchmark::State& state) {
+  static const std::vector<std::string_view> mix = MakeDocumentMix();
+  static Latencies latencies;
+
+  std::pmr::monotonic_buffer_resource arena;
+  std::pmr::unsynchronized_pool_resource pool(&arena);
+  markdown::Parser parser = Arena ? markdown::Parser(&pool)
+                                  : markdown::Parser();
+  for (std::string_view doc : mix) {
+    parser.Parse(doc);
+  }
+
+  std::vector<int64_t> nanos;
+  nanos.reserve(state.max_iterations);
+  size_t next = state.thread_index() * 7, bytes = 0;
+  for (auto _ : state) {
+    std::string_view doc = mix[next++ % mix.size()];
+    auto start = std::chrono::steady_clock::now();
+    benchmark::DoNotOptimize(parser.Parse(doc));
+    nanos.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                        std::chrono::steady_clock::now() - start)
+                        .count());
+    bytes += doc.size();
+  }
+  state.SetBytesProcessed(bytes);
+  state.counters["docs"] =
+      benchmark::Counter(state.iterations(), benchmark::Counter::kIsRate);
+  latencies.Report(state, nanos);
+}
+
+static void BM_ParseCommonMark1MB(benchmark::State& state) {
+  for (auto _ : state) {
+    cmp.Parse(md_1MB);
+  }
+}
+
+static void BM_ParseCommonMark100KB(benchmark::State& state) {
+  for (auto _ : state) {
+    cmp.Parse(md_100KB);
+  }
+}
+
+static void BM_SerializeBinary1MB(benchmark::State& state) {
+  markdown::Node root = p.Parse(md_1MB);
+  std::string bytes;
+  for (auto _ : state) {
+    markdown::SerializeBinary(root, bytes);
+    benchmark::DoNotOptimize(bytes.data());
+  }
+}
+
+static void BM_LoadBinary1MB(benchmark::State& state) {
+  std::string bytes = markdown::SerializeBinary(p.Parse(md_1MB));
+  for (auto _ : state) {
+    markdown::BinaryTree tree(bytes);
+    benchmark::DoNotOptimize(tree.Root().ChildCount());
+  }
+}
+
+static void BM_WalkBinary1MB(benchmark::State& state) {
+  std::string bytes = markdown::SerializeBinary(p.Parse(md_1MB));
+  markdown::BinaryTree tree(bytes);
+  for (auto _ : state) {
+    size_t textBytes = 0;
+    for (uint32_t i = 0; i < tree.NodeCount(); i++) {
+      textBytes += tree.At(i).Text().size();
+    }
+    benchmark::DoNotOptimize(textBytes);
+  }
+}
+
+static void BM_ParseFile(benchmark::State& state) {
+  for (auto _ : state) {
+    markdown::Document doc = markdown::ParseFile("data.md");
+    benchmark::DoNotOptimize(&doc.Root());
+  }
+  state.SetBytesProcessed(state.iterations() * md_content.size());
+}
+
+#ifdef PARSEMD_STATS
+// Where the time of a 1MB parse goes, its trace is left in parse_trace.json
+static void BM_ParseStats1MB(benchmark::State& state) {
+  markdown::Parser parser;
+  for (auto _ : state) {
+    parser.ClearStats(true);
+    parser.Parse(md_1MB);
+  }
+
+  using markdown::ParseStats;
+  const ParseStats& stats = parser.Stats();
+  for (size_t i = 0; i < ParseStats::stageCount; i++) {
+    std::string name(ParseStats::StageName(static_cast<ParseStats::Stage>(i)));
+    state.counters[name + " ms"] = stats.stageNanos[i] / 1e6;
+  }
+  state.counters["lines"] = stats.lines;
+  state.counters["blocks"] = stats.blocks;
+  state.counters["tokens"] = stats.tokens;
+  state.counters["delimiter pushes"] = stats.delimiterPushes;
+  state.counters["opener steps"] = stats.openerSteps;
+  state.counters["nodes"] = stats.nodes;
+  state.counters["bytes allocated"] = stats.bytesAllocated;
+
+  std::string trace;
+  stats.WriteTrace(trace);
+  std::ofstream("parse_trace.json") << trace;
+}
+#endif
+
+// Outline only, inline content is never parsed
+static void BM_ParseLazy1MB(benchmark::State& state) {
+  for (auto _ : state) {
+    markdown::LazyDocument doc = markdown::ParseLazy(md_1MB);
+    benchmark::DoNotOptimize(doc.Size());
+  }
+  state.SetBytesProcessed(state.iterations() * md_1MB.size());
+}
+
+static void BM_ParseLazyRoot1MB(benchmark::State& state) {
+  for (auto _ : state) {
+    markdown::LazyDocument doc = markdown::ParseLazy(md_1MB);
+    benchmark::DoNotOptimize(&doc.Root());
+  }
+  state.SetBytesProcessed(state.iterations() * md_1MB.size());
+}
+
+// First heading and paragraph, as for a link preview
+static void BM_Snippet1MB(benchmark::State& state) {
+  for (auto _ : state) {
+    markdown::BlockReader reader(md_1MB);
+    markdown::Node heading, paragraph;
+    for (const markdown::Node& block : reader) {
+      if (!heading && markdown::IsHeading(block->Type())) {
+        heading = block;
+      } else if (!paragraph &&
+                 block->Type() == markdown::TokenType::Paragraph) {
+        paragraph = block;
+      }
+      if (heading && paragraph) {
+        break;
+      }
+    }
+    benchmark::DoNotOptimize(paragraph);
+  }
+}
+
+// One paragraph edited in the middle of the document
+static void BM_Diff1MB(benchmark::State& state) {
+  std::string edited(md_1MB);
+  edited.insert(edited.find("\n\n", edited.size() / 2), " edited");
+  markdown::Parser other;
+  markdown::Node before = p.Parse(md_1MB);
+  markdown::Node after = other.Parse(edited);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(markdown::DiffBlocks(*before, *after));
+  }
+}
+
+static void BM_DumpTree1MB(benchmark::State& state) {
+  markdown::Node root = p.Parse(md_1MB);
+  for (auto _ : state) {
+    std::string dump = markdown::Parser::DumpTree(root);
+    benchmark::DoNotOptimize(dump.data());
+  }
+}
+
+static size_t CountRecursive(markdown::Node node) {
+  size_t count = 1;
+  if (markdown::Container cnode = markdown::ContainerNodePtr(node)) {
+    for (markdown::Node child : cnode->children) {
+      count += CountRecursive(child);
+    }
+  }
+  return count;
+}
+
+// Walking by shared_ptr copies, as renderers used to
+static void BM_WalkRecursive1MB(benchmark::State& state) {
+  markdown::Node root = p.Parse(md_1MB);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(CountRecursive(root));
+  }
+}
+
+static void BM_WalkCursor1MB(benchmark::State& state) {
+  markdown::Node root = p.Parse(md_1MB);
+  markdown::Cursor cursor;
+  for (auto _ : state) {
+    size_t count = 0;
+    for (cursor.Reset(*root); cursor.Next();) {
+      count += cursor.GetEvent() == markdown::Cursor::Enter;
+    }
+    benchmark::DoNotOptimize(count);
+  }
+}
+
+static void BM_FlatBuild1MB(benchmark::State& state) {
+  markdown::Node root = p.Parse(md_1MB);
+  markdown::FlatTree tree;
+  for (auto _ : state) {
+    tree.Build(*root);
+    benchmark::DoNotOptimize(tree.Size());
+  }
+}
+
+static void BM_FlatWalk1MB(benchmark::State& state) {
+  markdown::FlatTree tree(p.Parse(md_1MB));
+  for (auto _ : state) {
+    size_t textBytes = 0;
+    for (const markdown::FlatNode& node : tree.Nodes()) {
+      textBytes += node.textSize;
+    }
+    benchmark::DoNotOptimize(textBytes);
+  }
+}
+
+static void BM_FlatTypeScan1MB(benchmark::State& state) {
+  markdown::FlatTree tree(p.Parse(md_1MB), true);
+  for (auto _ : state) {
+    size_t headings = 0;
+    for (uint8_t type : tree.Types()) {
+      headings += markdown::IsHeading(static_cast<markdown::TokenType>(type));
+    }
+    benchmark::DoNotOptimize(headings);
+  }
+}
+
+static void BM_Json1MB(benchmark::State& state) {
+  markdown::Node root = p.Parse(md_1MB);
+  size_t bytes = 0;
+  markdown::JsonWriter writer(
+      [&bytes](std::string_view chunk) { bytes += chunk.size(); });
+  for (auto _ : state) {
+    writer.Write(root);
+  }
+  benchmark::DoNotOptimize(bytes);
+  state.SetBytesProcessed(state.iterations() * md_1MB.size());
+}
+
+// End to end cost of serving a document as JSON
+static void BM_Html1MB(benchmark::State& state) {
+  markdown::Node root = p.Parse(md_1MB);
+  std::string out;
+  for (auto _ : state) {
+    markdown::ToHtml(*root, out);
+    benchmark::DoNotOptimize(out.data());
+  }
+  state.SetBytesProcessed(state.iterations() * md_1MB.size());
+}
+
+// Blocks rendered on state.range(0) threads, then copied together
+static void BM_HtmlParallel1MB(benchmark::State& state) {
+  markdown::Node root = p.Parse(md_1MB);
+  std::string out;
+  for (auto _ : state) {
+    markdown::ToHtmlParallel(*root, out, state.range(0));
+    benchmark::DoNotOptimize(out.data());
+  }
+  state.SetBytesProcessed(state.iterations() * md_1MB.size());
+}
+
+static void BM_ParseJson1MB(benchmark::State& state) {
+  size_t bytes = 0;
+  markdown::JsonWriter writer(
+      [&bytes](std::string_view chunk) { bytes += chunk.size(); });
+  for (auto _ : state) {
+    writer.Write(p.Parse(md_1MB));
+  }
+  benchmark::DoNotOptimize(bytes);
+  state.SetBytesProcessed(state.iterations() * md_1MB.size());
+}
+
+// Inputs fuzz_parse flagged as slow, see fuzz/readme.md
+static void BM_ParseRegression(benchmark::State& state, std::string input) {
+  for (auto _ : state) {
+    p.Parse(input);
+  }
+  state.SetBytesProcessed(state.iterations() * input.size());
+}
+
+static void RegisterRegressions() {
+  for (const auto& entry :
+       std::filesystem::directory_iterator(PARSEMD_REGRESSIONS_DIR)) {
+    std::ifstream file(entry.path(), std::ios::binary);
+    std::string input(std::istreambuf_iterator<char>(file), {});
+    std::string name = "Regression " + entry.path().stem().string();
+    benchmark::RegisterBenchmark(name.c_str(), BM_ParseRegression, input);
+  }
+}
+
 static void BM_ParseEmpty(benchmark::State& state) {
   for (auto _ : state) {
     p.Parse("");
@@ -66,5 +453,44 @@ int main(int argc, char* argv[]) {
   benchmark::RegisterBenchmark("ParseMd Simple String", BM_ParseSimple);
   benchmark::RegisterBenchmark("ParseMd 100KB", BM_Parse100KB);
   benchmark::RegisterBenchmark("ParseMd 1MB", BM_Parse1MB);
+  benchmark::RegisterBenchmark("ParseMd 1MB Padded", BM_ParsePadded1MB);
+  benchmark::RegisterBenchmark("ParseMd 1MB Borrowed", BM_ParseBorrowed1MB);
+  benchmark::RegisterBenchmark("ParseMd 1MB Monotonic", BM_ParseMonotonic1MB);
+  int threads = std::max(std::thread::hardware_concurrency(), 1u);
+  benchmark::RegisterBenchmark("ParseMd Mix Threads", BM_ParseThreads<false>)
+      ->ThreadRange(1, threads)
+      ->UseRealTime();
+  benchmark::RegisterBenchmark("ParseMd Mix Threads Arena",
+                               BM_ParseThreads<true>)
+      ->ThreadRange(1, threads)
+      ->UseRealTime();
+  benchmark::RegisterBenchmark("ParseMd CommonMark 100KB",
+                               BM_ParseCommonMark100KB);
+  benchmark::RegisterBenchmark("ParseMd CommonMark 1MB", BM_ParseCommonMark1MB);
+  benchmark::RegisterBenchmark("ParseFile data.md", BM_ParseFile);
+#ifdef PARSEMD_STATS
+  benchmark::RegisterBenchmark("ParseMd 1MB Stats", BM_ParseStats1MB);
+#endif
+  benchmark::RegisterBenchmark("ParseLazy 1MB", BM_ParseLazy1MB);
+  benchmark::RegisterBenchmark("ParseLazy Root 1MB", BM_ParseLazyRoot1MB);
+  benchmark::RegisterBenchmark("Snippet 1MB", BM_Snippet1MB);
+  benchmark::RegisterBenchmark("Diff 1MB", BM_Diff1MB);
+  benchmark::RegisterBenchmark("DumpTree 1MB", BM_DumpTree1MB);
+  benchmark::RegisterBenchmark("Walk Recursive 1MB", BM_WalkRecursive1MB);
+  benchmark::RegisterBenchmark("Walk Cursor 1MB", BM_WalkCursor1MB);
+  benchmark::RegisterBenchmark("Flat Build 1MB", BM_FlatBuild1MB);
+  benchmark::RegisterBenchmark("Flat Walk 1MB", BM_FlatWalk1MB);
+  benchmark::RegisterBenchmark("Flat Type Scan 1MB", BM_FlatTypeScan1MB);
+  benchmark::RegisterBenchmark("Json 1MB", BM_Json1MB);
+  benchmark::RegisterBenchmark("ParseMd+Json 1MB", BM_ParseJson1MB);
+  benchmark::RegisterBenchmark("Html 1MB", BM_Html1MB);
+  benchmark::RegisterBenchmark("Html 1MB Parallel", BM_HtmlParallel1MB)
+      ->Arg(2)
+      ->Arg(4)
+      ->UseRealTime();
+  benchmark::RegisterBenchmark("Binary Serialize 1MB", BM_SerializeBinary1MB);
+  benchmark::RegisterBenchmark("Binary Load 1MB", BM_LoadBinary1MB);
+  benchmark::RegisterBenchmark("Binary Walk 1MB", BM_WalkBinary1MB);
+  RegisterRegressions();
   benchmark::RunSpecifiedBenchmarks();
 }
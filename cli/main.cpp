@@ -0,0 +1,187 @@
+// parsemd: converts markdown files, or every markdown file below a directory,
+// to HTML, JSON or plain text.
+//
+//   parsemd -o site/ -j 8 docs/
+//   find docs -name '*.md' | parsemd -f json -o out/ -l -
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "pipeline.h"
+
+namespace fs = std::filesystem;
+
+static const char usage[] =
+    "usage: parsemd [options] <file|dir>...\n"
+    "  -f, --format html|json|text  output format (html)\n"
+    "  -o, --output DIR             mirror the inputs below DIR, else write\n"
+    "                               everything to stdout. Files keep their\n"
+    "                               path, directories the paths below them\n"
+    "  -l, --list FILE              more inputs, one per line, - for stdin\n"
+    "  -j, --jobs N                 parse workers (hardware threads)\n"
+    "  -r, --render-jobs N          render workers (jobs / 4, at least 1)\n"
+    "  -b, --block-jobs N           threads per HTML document of 256KB and\n"
+    "                               more, rendering its blocks (1)\n"
+    "  -q, --queue N                files waiting between two stages (64)\n"
+    "      --max-depth N            deepest emphasis nesting, files nesting\n"
+    "                               deeper fail (1000)\n"
+    "      --commonmark             no GFM extensions\n"
+    "  -h, --help\n";
+
+// Parsing and freeing a tree recurse once per level, on a thread's stack
+static constexpr size_t maxDepthLimit = 10000;
+
+[[noreturn]] static void Fail(const std::string& message) {
+  std::fprintf(stderr, "parsemd: %s\n%s", message.c_str(), usage);
+  std::exit(2);
+}
+
+static size_t Count(const char* arg) {
+  char* end;
+  unsigned long value = std::strtoul(arg, &end, 10);
+  if (*arg == '\0' || *end != '\0' || value == 0) {
+    Fail(std::string("expected a positive number, got ") + arg);
+  }
+  return value;
+}
+
+static bool IsMarkdown(const fs::path& path) {
+  return path.extension() == ".md" || path.extension() == ".markdown";
+}
+
+// A file keeps its path below -o, without the root and leading "..", so
+// in/a/README.md and in/b/README.md do not end up in the same output
+static std::string FileStem(const std::string& arg) {
+  fs::path stem;
+  fs::path path = fs::path(arg).lexically_normal().relative_path();
+  for (const fs::path& part : path) {
+    if (!(stem.empty() && part == "..")) {
+      stem /= part;
+    }
+  }
+  return stem.replace_extension().string();
+}
+
+// Files stand for themselves, directories for their markdown files, sorted
+// so that output to stdout does not depend on the directory order
+static void AddInput(const std::string& arg, std::vector<cli::Input>& inputs) {
+  std::error_code ec;
+  if (!fs::is_directory(arg, ec)) {
+    inputs.push_back({arg, FileStem(arg)});
+    return;
+  }
+  size_t first = inputs.size();
+  for (fs::recursive_directory_iterator it(arg, ec), end; !ec && it != end;
+       it.increment(ec)) {
+    if (it->is_regular_file(ec) && IsMarkdown(it->path())) {
+      fs::path stem = it->path().lexically_relative(arg);
+      inputs.push_back(
+          {it->path().string(), stem.replace_extension().string()});
+    }
+  }
+  if (ec) {
+    std::fprintf(stderr, "parsemd: %s: %s\n", arg.c_str(),
+                 ec.message().c_str());
+  }
+  std::sort(inputs.begin() + first, inputs.end(),
+            [](const cli::Input& a, const cli::Input& b) {
+              return a.path < b.path;
+            });
+}
+
+static void AddList(const std::string& list, std::vector<cli::Input>& inputs) {
+  std::ifstream file;
+  if (list != "-") {
+    file.open(list);
+    if (!file) {
+      Fail("cannot read " + list);
+    }
+  }
+  std::istream& in = list == "-" ? std::cin : file;
+  for (std::string line; std::getline(in, line);) {
+    if (!line.empty()) {
+      AddInput(line, inputs);
+    }
+  }
+}
+
+int main(int argc, char* argv[]) {
+  cli::Options options;
+  options.jobs = std::max(std::thread::hardware_concurrency(), 1u);
+  bool renderJobs = false;
+  std::vector<cli::Input> inputs;
+
+  for (int i = 1; i < argc; i++) {
+    std::string arg = argv[i];
+    auto value = [&]() -> const char* {
+      if (i + 1 == argc) {
+        Fail(arg + " needs a value");
+      }
+      return argv[++i];
+    };
+    if (arg == "-h" || arg == "--help") {
+      std::fputs(usage, stdout);
+      return 0;
+    } else if (arg == "-f" || arg == "--format") {
+      std::string format = value();
+      if (format == "html") {
+        options.format = cli::Format::Html;
+      } else if (format == "json") {
+        options.format = cli::Format::Json;
+      } else if (format == "text") {
+        options.format = cli::Format::Text;
+      } else {
+        Fail("unknown format " + format);
+      }
+    } else if (arg == "-o" || arg == "--output") {
+      options.outputDir = value();
+    } else if (arg == "-l" || arg == "--list") {
+      AddList(value(), inputs);
+    } else if (arg == "-j" || arg == "--jobs") {
+      options.jobs = Count(value());
+    } else if (arg == "-r" || arg == "--render-jobs") {
+      options.renderJobs = Count(value());
+      renderJobs = true;
+    } else if (arg == "-b" || arg == "--block-jobs") {
+      options.blockJobs = Count(value());
+    } else if (arg == "-q" || arg == "--queue") {
+      options.queueCapacity = Count(value());
+    } else if (arg == "--max-depth") {
+      options.maxDepth = Count(value());
+      if (options.maxDepth > maxDepthLimit) {
+        Fail("--max-depth is at most " + std::to_string(maxDepthLimit));
+      }
+    } else if (arg == "--commonmark") {
+      options.commonMark = true;
+    } else if (arg.size() > 1 && arg[0] == '-') {
+      Fail("unknown option " + arg);
+    } else {
+      AddInput(arg, inputs);
+    }
+  }
+  if (inputs.empty()) {
+    Fail("no input files");
+  }
+  // rendering takes a fraction of the parse time
+  if (!renderJobs) {
+    options.renderJobs = std::max<size_t>(options.jobs / 4, 1);
+  }
+
+  cli::Report report = cli::Run(inputs, options);
+  double mb = report.bytesRead / (1024.0 * 1024.0);
+  double seconds = std::max(report.seconds, 1e-9);
+  std::fprintf(stderr,
+               "%zu files, %zu failed, %.1f MB in %.3f s: %.0f files/s, "
+               "%.1f MB/s\n",
+               report.files, report.failed, mb, report.seconds,
+               report.files / seconds, mb / seconds);
+  return report.failed ? 1 : 0;
+}
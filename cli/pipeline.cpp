@@ -0,0 +1,341 @@
+#include <fcntl.h>
+#include <limits.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <system_error>
+#include <thread>
+#include <unordered_map>
+
+#include "parsemd/cursor.h"
+#include "parsemd/html.h"
+#include "parsemd/json.h"
+#include "parsemd/mappedfile.h"
+#include "parsemd/node.h"
+#include "parsemd/parser.h"
+#include "pipeline.h"
+#include "queue.h"
+
+namespace md = markdown;
+
+namespace cli {
+
+namespace {
+
+struct Job {
+  size_t index;
+  const Input* input;
+  md::MappedFile file;
+  uint64_t size = 0;
+  md::Node root;
+  // written in order with one gather, more than one chunk only for documents
+  // whose blocks were rendered in parallel
+  std::vector<std::string> output;
+  // set by the first stage that fails, the later ones pass the job on
+  std::string error;
+};
+using JobPtr = std::unique_ptr<Job>;
+using JobQueue = BoundedQueue<JobPtr>;
+// Files the reader may start ahead of stdout, one more than the queue
+// capacity. The writer hands a ticket back per file written, so at most the
+// queue capacity of files wait there for one still being converted.
+using Tickets = BoundedQueue<bool>;
+
+// Smaller documents are not worth starting threads for
+constexpr uint64_t blockJobsMinSize = 256 << 10;
+
+const char* Extension(Format format) {
+  switch (format) {
+    case Format::Json:
+      return ".json";
+    case Format::Text:
+      return ".txt";
+    default:
+      return ".html";
+  }
+}
+
+// Text of the inlines, blocks end in a newline and table cells in a tab
+void ToText(const md::NodeBase& root, std::string& out) {
+  out.clear();
+  for (md::Cursor cursor(root, SIZE_MAX); cursor.Next();) {
+    const md::NodeBase& current = cursor.Current();
+    if (const md::TextNode* text = md::TextNodePtr(&current)) {
+      out.append(text->text);
+      continue;
+    }
+    md::TokenType type = current.Type();
+    if (type == md::TokenType::Softbreak) {
+      if (cursor.GetEvent() == md::Cursor::Enter && !out.empty() &&
+          out.back() != '\n') {
+        out += '\n';
+      }
+    } else if (cursor.GetEvent() == md::Cursor::Exit) {
+      if (type == md::TokenType::TableCell) {
+        out += '\t';
+      } else if (type == md::TokenType::TableHead ||
+                 type == md::TokenType::TableRow) {
+        if (!out.empty() && out.back() == '\t') {
+          out.pop_back();
+        }
+        out += '\n';
+      } else if (md::IsBlock(type) && type != md::TokenType::Root &&
+                 type != md::TokenType::Table) {
+        out += '\n';
+      }
+    }
+  }
+}
+
+void Read(const std::vector<Input>& inputs,
+          const Options& options,
+          Tickets& tickets,
+          JobQueue& out) {
+  // output stem -> the input writing it, a later input never overwrites it
+  std::unordered_map<std::string_view, const Input*> outputs;
+  for (size_t i = 0; i < inputs.size(); i++) {
+    bool ticket;
+    if (options.outputDir.empty() && !tickets.Pop(ticket)) {
+      break;
+    }
+    JobPtr job = std::make_unique<Job>();
+    job->index = i;
+    job->input = &inputs[i];
+    if (!options.outputDir.empty()) {
+      auto [it, added] = outputs.emplace(inputs[i].outputStem, &inputs[i]);
+      if (!added) {
+        job->error = "same output as " + it->second->path;
+        out.Push(std::move(job));
+        continue;
+      }
+    }
+    if (!job->file.Open(inputs[i].path, true)) {
+      job->error = std::generic_category().message(errno);
+    }
+    job->size = job->file.Size();
+    out.Push(std::move(job));
+  }
+}
+
+// One parser per worker, kept for all its files so its scratch is reused.
+// A parse cut short by a limit fails the file.
+template <md::Extension Ext>
+void Parse(JobQueue& in, JobQueue& out, const Options& options) {
+  md::BasicParser<Ext> parser;
+  md::ParseLimits limits;
+  limits.maxDepth = options.maxDepth;
+  parser.SetLimits(limits);
+  for (JobPtr job; in.Pop(job);) {
+    if (job->error.empty()) {
+      parser.BorrowDocument(job->file.View());
+      job->root = parser.Parse();
+      if (parser.Truncated() != md::ParseLimits::None) {
+        job->error = "exceeds the ";
+        job->error += md::ParseLimits::LimitName(parser.Truncated());
+        job->error += " limit";
+        job->root = nullptr;
+      }
+    }
+    out.Push(std::move(job));
+  }
+  parser.Reset();
+}
+
+void Render(JobQueue& in, JobQueue& out, const Options& options) {
+  std::string* target = nullptr;
+  auto sink = [&target](std::string_view chunk) { target->append(chunk); };
+  md::HtmlWriter html(sink);
+  md::JsonWriter json(sink);
+  for (JobPtr job; in.Pop(job);) {
+    if (job->error.empty()) {
+      if (options.format == Format::Html && options.blockJobs > 1 &&
+          job->size >= blockJobsMinSize) {
+        job->output = md::ToHtmlChunks(*job->root, options.blockJobs);
+      } else {
+        target = &job->output.emplace_back();
+        if (options.format == Format::Html) {
+          html.Write(job->root);
+        } else if (options.format == Format::Json) {
+          json.Write(job->root);
+        } else {
+          ToText(*job->root, *target);
+        }
+      }
+      // the tree points into the mapping, both go before the write
+      job->root = nullptr;
+      job->file.Close();
+    }
+    out.Push(std::move(job));
+  }
+}
+
+// The chunks in order, IOV_MAX at a time, resumed after short writes
+bool WriteAll(int fd, const std::vector<std::string>& chunks) {
+  std::vector<iovec> iov;
+  for (const std::string& chunk : chunks) {
+    if (!chunk.empty()) {
+      iov.push_back({const_cast<char*>(chunk.data()), chunk.size()});
+    }
+  }
+  for (iovec* it = iov.data(); it != iov.data() + iov.size();) {
+    int count = std::min<size_t>(iov.data() + iov.size() - it, IOV_MAX);
+    ssize_t written = ::writev(fd, it, count);
+    if (written < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return false;
+    }
+    for (; it != iov.data() + iov.size() && size_t(written) >= it->iov_len;
+         it++) {
+      written -= it->iov_len;
+    }
+    if (written > 0) {
+      it->iov_base = static_cast<char*>(it->iov_base) + written;
+      it->iov_len -= written;
+    }
+  }
+  return true;
+}
+
+class Writer {
+ public:
+  Writer(const Options& options, Report& report)
+      : options_(options), report_(report) {}
+
+  void Run(JobQueue& in, Tickets& tickets) {
+    if (!options_.outputDir.empty()) {
+      for (JobPtr job; in.Pop(job);) {
+        Write(*job);
+      }
+      return;
+    }
+    // stdout keeps the input order, jobs that overtook others wait here,
+    // bounded by the tickets
+    std::map<size_t, JobPtr> pending;
+    size_t next = 0;
+    for (JobPtr job; in.Pop(job);) {
+      pending.emplace(job->index, std::move(job));
+      for (auto it = pending.begin();
+           it != pending.end() && it->first == next;
+           it = pending.erase(it), next++) {
+        Write(*it->second);
+        tickets.Push(true);
+      }
+    }
+  }
+
+ protected:
+  const Options& options_;
+  Report& report_;
+  // parent of the last output, known to exist
+  std::filesystem::path dir_;
+
+  void Write(Job& job) {
+    report_.files++;
+    if (job.error.empty() && !WriteOutput(job)) {
+      job.error = std::generic_category().message(errno);
+    }
+    if (!job.error.empty()) {
+      report_.failed++;
+      std::fprintf(stderr, "parsemd: %s: %s\n", job.input->path.c_str(),
+                   job.error.c_str());
+      return;
+    }
+    report_.bytesRead += job.size;
+    for (const std::string& chunk : job.output) {
+      report_.bytesWritten += chunk.size();
+    }
+  }
+
+  bool WriteOutput(const Job& job) {
+    if (options_.outputDir.empty()) {
+      return WriteAll(STDOUT_FILENO, job.output);
+    }
+    std::filesystem::path path = options_.outputDir;
+    path /= job.input->outputStem + Extension(options_.format);
+    if (path.parent_path() != dir_) {
+      std::error_code ec;
+      std::filesystem::create_directories(path.parent_path(), ec);
+      if (ec) {
+        errno = ec.value();
+        return false;
+      }
+      dir_ = path.parent_path();
+    }
+    int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC,
+                    0644);
+    if (fd < 0) {
+      return false;
+    }
+    bool ok = WriteAll(fd, job.output);
+    int error = errno;
+    ok = ::close(fd) == 0 && ok;
+    if (!ok && error) {
+      errno = error;
+    }
+    return ok;
+  }
+};
+
+}  // namespace
+
+Report Run(const std::vector<Input>& inputs, const Options& options) {
+  auto start = std::chrono::steady_clock::now();
+  Report report;
+
+  JobQueue parseQueue(options.queueCapacity);
+  JobQueue renderQueue(options.queueCapacity);
+  JobQueue writeQueue(options.queueCapacity);
+  Tickets tickets(options.queueCapacity + 1);
+  for (size_t i = 0; i < options.queueCapacity + 1; i++) {
+    tickets.Push(true);
+  }
+
+  std::thread reader(Read, std::cref(inputs), std::cref(options),
+                     std::ref(tickets), std::ref(parseQueue));
+  std::vector<std::thread> parsers, renderers;
+  for (size_t i = 0; i < std::max<size_t>(options.jobs, 1); i++) {
+    if (options.commonMark) {
+      parsers.emplace_back(Parse<md::dialect::CommonMark>,
+                           std::ref(parseQueue), std::ref(renderQueue),
+                           std::cref(options));
+    } else {
+      parsers.emplace_back(Parse<md::dialect::GFM>, std::ref(parseQueue),
+                           std::ref(renderQueue), std::cref(options));
+    }
+  }
+  for (size_t i = 0; i < std::max<size_t>(options.renderJobs, 1); i++) {
+    renderers.emplace_back(Render, std::ref(renderQueue),
+                           std::ref(writeQueue), std::cref(options));
+  }
+  Writer writer(options, report);
+  std::thread writerThread([&] { writer.Run(writeQueue, tickets); });
+
+  // a stage is done once everyone feeding it is
+  reader.join();
+  parseQueue.Close();
+  for (std::thread& parser : parsers) {
+    parser.join();
+  }
+  renderQueue.Close();
+  for (std::thread& renderer : renderers) {
+    renderer.join();
+  }
+  writeQueue.Close();
+  writerThread.join();
+
+  report.seconds = std::chrono::duration<double>(
+                       std::chrono::steady_clock::now() - start)
+                       .count();
+  return report;
+}
+
+}  // namespace cli
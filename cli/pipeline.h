@@ -0,0 +1,59 @@
+#ifndef PARSEMD_CLI_PIPELINE_H_
+#define PARSEMD_CLI_PIPELINE_H_
+
+// Conversion of many files as a pipeline of four stages, connected by bounded
+// queues:
+//
+//   read (1) -> parse (jobs) -> render (renderJobs) -> write (1)
+//
+// Reading maps the file, parsing borrows the mapping, so a file is never
+// copied on its way in. Each stage frees what the next does not need, the
+// queue capacity bounds the files in flight. Large documents can have their
+// blocks rendered in parallel, the chunks are written with one writev.
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "parsemd/limits.h"
+
+namespace cli {
+
+enum class Format { Html, Json, Text };
+
+struct Options {
+  Format format = Format::Html;
+  bool commonMark = false;
+  size_t jobs = 1;
+  size_t renderJobs = 1;
+  // threads rendering the blocks of one large HTML document
+  size_t blockJobs = 1;
+  size_t queueCapacity = 64;
+  // emphasis nested deeper is literal text and fails the file
+  size_t maxDepth = markdown::ParseLimits::defaultMaxDepth;
+  // outputs are mirrored below it, empty for stdout in input order
+  std::string outputDir;
+};
+
+struct Input {
+  std::string path;
+  // below Options::outputDir, without extension
+  std::string outputStem;
+};
+
+struct Report {
+  size_t files = 0;
+  size_t failed = 0;
+  uint64_t bytesRead = 0;
+  uint64_t bytesWritten = 0;
+  double seconds = 0;
+};
+
+// Errors are printed to stderr and counted in Report::failed, the other
+// files are converted regardless. With an output directory, an input whose
+// outputStem an earlier one already has fails instead of overwriting it.
+Report Run(const std::vector<Input>& inputs, const Options& options);
+
+}  // namespace cli
+
+#endif  // !PARSEMD_CLI_PIPELINE_H_
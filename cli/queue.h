@@ -0,0 +1,67 @@
+#ifndef PARSEMD_CLI_QUEUE_H_
+#define PARSEMD_CLI_QUEUE_H_
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+
+namespace cli {
+
+// Hands items from one pipeline stage to the next. Push blocks while the
+// queue is full, so a slow stage holds back the ones before it instead of
+// letting mapped files and trees pile up.
+template <typename T>
+class BoundedQueue {
+ public:
+  explicit BoundedQueue(size_t capacity) : capacity_(capacity ? capacity : 1) {}
+
+  // Blocks while full, false once closed
+  bool Push(T item) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    notFull_.wait(lock,
+                  [this] { return closed_ || items_.size() < capacity_; });
+    if (closed_) {
+      return false;
+    }
+    items_.push_back(std::move(item));
+    lock.unlock();
+    notEmpty_.notify_one();
+    return true;
+  }
+
+  // Blocks while empty, false once closed and drained
+  bool Pop(T& item) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    notEmpty_.wait(lock, [this] { return closed_ || !items_.empty(); });
+    if (items_.empty()) {
+      return false;
+    }
+    item = std::move(items_.front());
+    items_.pop_front();
+    lock.unlock();
+    notFull_.notify_one();
+    return true;
+  }
+
+  // No more pushes, consumers drain what is left
+  void Close() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      closed_ = true;
+    }
+    notFull_.notify_all();
+    notEmpty_.notify_all();
+  }
+
+ protected:
+  std::mutex mutex_;
+  std::condition_variable notFull_;
+  std::condition_variable notEmpty_;
+  std::deque<T> items_;
+  size_t capacity_;
+  bool closed_ = false;
+};
+
+}  // namespace cli
+
+#endif  // !PARSEMD_CLI_QUEUE_H_
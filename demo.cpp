@@ -6,6 +6,7 @@
 #include <string>
 #include <unordered_map>
 
+#include "parsemd/cursor.h"
 #include "parsemd/node.h"
 #include "parsemd/parser.h"
 #include "parsemd/types.h"
@@ -20,8 +21,6 @@ using RenderRules = unordered_map<md::TokenType, pair<string, string>>;
 struct Renderer {
   Renderer(const RenderRules& rules) : rules(rules) {}
   void Render(const md::Node& node);
-  void RenderContainer(const md::Container& node);
-  void RenderText(const md::Text& node);
 
  protected:
   const RenderRules& rules;
@@ -93,27 +92,18 @@ Mode getMode(int argc, char* argv[]) {
 }
 
 void Renderer::Render(const md::Node& node) {
-  if (!node) {
-    return;
-  }
-  if (md::IsText(node)) {
-    RenderText(md::TextNodePtr(node));
-  } else {
-    RenderContainer(md::ContainerNodePtr(node));
+  for (md::Cursor cursor(node); cursor.Next();) {
+    const md::NodeBase& current = cursor.Current();
+    if (const md::TextNode* text = md::TextNodePtr(&current)) {
+      cout << text->text;
+    } else if (cursor.GetEvent() == md::Cursor::Enter) {
+      cout << rules.at(current.Type()).first;
+    } else {
+      cout << rules.at(current.Type()).second;
+    }
   }
 }
 
-void Renderer::RenderContainer(const md::Container& node) {
-  cout << rules.at(node->Type()).first;
-  for (md::Node child : node->children)
-    Render(child);
-  cout << rules.at(node->Type()).second;
-}
-
-void Renderer::RenderText(const md::Text& node) {
-  std::cout << node->text;
-}
-
 HTMLRenderer::HTMLRenderer() : Renderer(HTMLRenderRules()) {}
 const RenderRules& HTMLRenderer::HTMLRenderRules() {
   static RenderRules rules;
@@ -122,7 +112,12 @@ const RenderRules& HTMLRenderer::HTMLRenderRules() {
         rules[md::TokenType::Softbreak] = {"", ""};
     rules[md::TokenType::Strong] = {"<b>", "</b>"};
     rules[md::TokenType::Emph] = {"<i>", "</i>"};
+    rules[md::TokenType::Strikethrough] = {"<del>", "</del>"};
     rules[md::TokenType::Paragraph] = {"<p>", "</p>\n"};
+    rules[md::TokenType::Table] = {"<table>\n", "</table>\n"};
+    rules[md::TokenType::TableHead] = {"<thead>\n<tr>\n", "</tr>\n</thead>\n"};
+    rules[md::TokenType::TableRow] = {"<tr>\n", "</tr>\n"};
+    rules[md::TokenType::TableCell] = {"<td>", "</td>\n"};
 
     // clang-format off
     for (int i = 0; i <= 5; i++) {
@@ -145,11 +140,16 @@ const RenderRules& ANSIRenderer::ANSIRenderRules() {
         rules[md::TokenType::Softbreak] = {"", ""};
     rules[md::TokenType::Strong] = {CSI + "1m", CSI + "22m"};
     rules[md::TokenType::Emph] = {CSI + "3m", CSI + "23m"};
+    rules[md::TokenType::Strikethrough] = {CSI + "9m", CSI + "29m"};
     rules[md::TokenType::StrongEmph] = {
       CSI + "1m" + CSI + "3m",
       CSI + "23m" + CSI + "22m"
     };
     rules[md::TokenType::Paragraph] = {"", "\n\n"};
+    rules[md::TokenType::Table] = {"", "\n"};
+    rules[md::TokenType::TableHead] = {CSI + "1m", CSI + "22m\n"};
+    rules[md::TokenType::TableRow] = {"", "\n"};
+    rules[md::TokenType::TableCell] = {"", "\t"};
 
     for (int i = 0; i <= 5; i++) {
       rules[md::TokenType::H1 + i] = {
@@ -0,0 +1,62 @@
+// Parses every input with both dialects. A parse that takes much longer per
+// byte than the parser normally does aborts, so libFuzzer saves the input as a
+// crash; such inputs belong in fuzz/regressions, where the tests and the
+// benchmark pick them up. The unchecked scanner routines of padded input are
+// checked against the unpadded ones as well.
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+#include "parsemd/parser.h"
+
+namespace {
+
+// Below this the fixed cost of a parse dominates its time
+constexpr size_t minTimedSize = 1024;
+
+double MaxNanosPerByte() {
+  static const double limit = [] {
+    const char* env = std::getenv("PARSEMD_FUZZ_MAX_NS_PER_BYTE");
+    return env ? std::atof(env) : 5000.0;
+  }();
+  return limit;
+}
+
+template <class P>
+void ParseTimed(P& parser, std::string_view input, const char* dialect) {
+  auto begin = std::chrono::steady_clock::now();
+  markdown::Node root = parser.Parse(input);
+  auto end = std::chrono::steady_clock::now();
+
+  double nanos = std::chrono::duration<double, std::nano>(end - begin).count();
+  if (input.size() >= minTimedSize &&
+      nanos / input.size() > MaxNanosPerByte()) {
+    std::fprintf(stderr,
+                 "parsemd: slow %s parse, %zu bytes in %.3f ms "
+                 "(%.0f ns/byte)\n",
+                 dialect, input.size(), nanos / 1e6, nanos / input.size());
+    std::abort();
+  }
+  std::string tree = markdown::Parser::DumpTree(root);
+
+  // a borrowed string_view is not padded
+  parser.BorrowDocument(input);
+  if (markdown::Parser::DumpTree(parser.Parse()) != tree) {
+    std::fprintf(stderr, "parsemd: %s trees of padded and unpadded differ\n",
+                 dialect);
+    std::abort();
+  }
+}
+
+}  // namespace
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+  static markdown::Parser gfm;
+  static markdown::CommonMarkParser commonMark;
+
+  std::string_view input(reinterpret_cast<const char*>(data), size);
+  ParseTimed(gfm, input, "GFM");
+  ParseTimed(commonMark, input, "CommonMark");
+  return 0;
+}
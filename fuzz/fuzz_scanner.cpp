@@ -0,0 +1,126 @@
+// Drives Scanner and DelimiterStack directly, without the parser keeping their
+// arguments in range. Input is `ops '\0' text`: every op byte runs one scanner
+// call on text, then the delimiter runs of text go through ProcessEmphasis with
+// opener/closer types taken from the ops. Anything read outside text aborts.
+
+#include <cstdio>
+#include <cstdlib>
+
+#include "parsemd/delimiterstack.h"
+#include "parsemd/internal.h"
+#include "parsemd/scanner.h"
+
+namespace {
+
+using markdown::DelimiterStack;
+using markdown::Scanner;
+
+std::string_view text;
+
+void Check(bool ok, const char* what) {
+  if (!ok) {
+    std::fprintf(stderr, "parsemd: %s outside of the input\n", what);
+    std::abort();
+  }
+}
+
+bool Within(std::string_view sv) {
+  return sv.empty() || (sv.data() >= text.data() &&
+                        sv.data() + sv.size() <= text.data() + text.size());
+}
+
+void RunScanner(std::string_view ops) {
+  Scanner scanner(text);
+  for (unsigned char op : ops) {
+    unsigned arg = op >> 3;
+    auto curPos = static_cast<Scanner::CurPos>(arg % 5);
+    int offset = static_cast<int>(arg / 5) - 3;
+
+    switch (op & 7) {
+      case 0:
+        scanner.ScanNextByte();
+        break;
+      case 1:
+        Check(Within(scanner.ScanNextLine()), "ScanNextLine");
+        break;
+      case 2:
+        Check(Within(scanner.PeekNextLine()), "PeekNextLine");
+        break;
+      case 3:
+        scanner.UnscanLine();
+        break;
+      case 4:
+        Check(Within(scanner.FlushCurrentLine()), "FlushCurrentLine");
+        break;
+      case 5:
+        scanner.FlushBytes(arg);
+        break;
+      case 6:
+        scanner.SkipNextBytes(arg);
+        break;
+      case 7:
+        scanner.At(curPos, offset);
+        scanner.LookAhead(curPos, offset);
+        Check(Within(scanner.Scan(arg % 4, curPos, offset)), "Scan");
+        break;
+    }
+    Check(Within(scanner.CurrentLine()), "CurrentLine");
+  }
+}
+
+void RunDelimiters(std::string_view ops) {
+  constexpr auto& kinds =
+      markdown::internal::delimiterKind<markdown::dialect::GFM>;
+  markdown::TokenList tokens;
+  DelimiterStack stack;
+
+  size_t op = 0;
+  for (size_t i = 0; i < text.size();) {
+    int kind = kinds[static_cast<unsigned char>(text[i])];
+    size_t count = 1;
+    while (i + count < text.size() && text[i + count] == text[i]) {
+      count++;
+    }
+    std::string_view run = text.substr(i, count);
+    i += count;
+
+    const markdown::internal::DelimiterRule* rule =
+        kind >= 0 ? &markdown::internal::delimiterRules[kind] : nullptr;
+    if (!rule || (rule->maxRun && count > rule->maxRun)) {
+      tokens.emplace_back(markdown::TokenType::Text, run);
+      continue;
+    }
+
+    unsigned char type = ops.empty() ? 2 : ops[op++ % ops.size()] % 3;
+    tokens.emplace_back(markdown::internal::GetMarker(run), run);
+    stack.Push({
+        .kind = static_cast<unsigned char>(kind),
+        .type = static_cast<DelimiterStack::DelimiterType>(type),
+        .isActive = true,
+        .number = count,
+        .tokenIt = std::prev(tokens.end()),
+    });
+  }
+
+  stack.ProcessEmphasis(tokens);
+  for (const markdown::Token& token : tokens) {
+    Check(Within(token.second), "Token");
+  }
+}
+
+}  // namespace
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+  std::string_view input(reinterpret_cast<const char*>(data), size);
+  size_t split = input.find('\0');
+  std::string_view ops;
+  text = input;
+  if (split != std::string_view::npos) {
+    ops = input.substr(0, split);
+    text = input.substr(split + 1);
+  }
+
+  RunScanner(ops);
+  RunDelimiters(ops);
+  return 0;
+}
@@ -0,0 +1,37 @@
+// Replays files, or every file of a directory, through a fuzz target for
+// compilers without libFuzzer. Use it to rerun a corpus or a saved crash.
+
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size);
+
+static void Run(const std::filesystem::path& path) {
+  std::ifstream file(path, std::ios::binary);
+  std::string input(std::istreambuf_iterator<char>(file), {});
+  LLVMFuzzerTestOneInput(reinterpret_cast<const uint8_t*>(input.data()),
+                         input.size());
+}
+
+int main(int argc, char* argv[]) {
+  size_t runs = 0;
+  for (int i = 1; i < argc; i++) {
+    std::filesystem::path path = argv[i];
+    if (!std::filesystem::is_directory(path)) {
+      Run(path);
+      runs++;
+      continue;
+    }
+    for (const auto& entry : std::filesystem::directory_iterator(path)) {
+      if (entry.is_regular_file()) {
+        Run(entry.path());
+        runs++;
+      }
+    }
+  }
+  std::fprintf(stderr, "%zu inputs replayed\n", runs);
+}
@@ -0,0 +1,90 @@
+#ifndef PARSEMD_BINARY_H_
+#define PARSEMD_BINARY_H_
+
+// Versioned binary AST that can be read in place, e.g. straight out of a
+// MappedFile, without deserializing.
+//
+// Layout (native byte order, every field 4-byte aligned):
+//   BinaryHeader
+//   BinaryNode[nodeCount]   breadth first, so the children of a node are the
+//                           contiguous range [firstChild, firstChild + count)
+//   char[stringBytes]       text of every node, back to back
+
+#include "types.h"
+
+namespace markdown {
+
+struct BinaryHeader {
+  char magic[4];
+  uint32_t version;
+  uint32_t nodeCount;
+  uint32_t stringBytes;
+  uint32_t flags;
+  uint32_t reserved;
+};
+
+struct BinaryNode {
+  uint8_t type;
+  uint8_t align;
+  uint16_t reserved;
+  uint32_t firstChild;
+  uint32_t childCount;
+  uint32_t text;
+  uint32_t textSize;
+  uint32_t sourceBegin;
+  uint32_t sourceEnd;
+};
+
+inline constexpr char binaryMagic[4] = {'P', 'M', 'D', 'B'};
+inline constexpr uint32_t binaryVersion = 1;
+// BinaryHeader::flags
+inline constexpr uint32_t binarySourcePos = 1 << 0;
+
+void SerializeBinary(const Node& root, std::string& out);
+std::string SerializeBinary(const Node& root);
+
+// Read-only view over serialized bytes. The bytes are not copied and must
+// outlive the tree and every NodeView handed out by it. Opening only checks
+// the header, nodes are bounds checked as they are visited.
+class BinaryTree {
+ public:
+  class NodeView {
+   public:
+    NodeView();
+    NodeView(const BinaryTree* tree, uint32_t index);
+    bool Valid() const;
+    uint32_t Index() const;
+    TokenType Type() const;
+    Alignment Align() const;
+    std::string_view Text() const;
+    SourceRange Source() const;
+    uint32_t ChildCount() const;
+    NodeView Child(uint32_t i) const;
+
+   protected:
+    const BinaryTree* tree_ = nullptr;
+    const BinaryNode* node_ = nullptr;
+    uint32_t index_ = 0;
+  };
+
+  BinaryTree();
+  BinaryTree(std::string_view bytes);
+  // The bytes would be freed before the tree is read
+  BinaryTree(std::string&&) = delete;
+  bool Init(std::string_view bytes);
+  bool Valid() const;
+
+  NodeView Root() const;
+  NodeView At(uint32_t index) const;
+  uint32_t NodeCount() const;
+  bool HasSourcePos() const;
+
+ protected:
+  const BinaryHeader* header_ = nullptr;
+  const BinaryNode* nodes_ = nullptr;
+  const char* strings_ = nullptr;
+};
+
+}  // namespace markdown
+
+#endif  // !PARSEMD_BINARY_H_
@@ -0,0 +1,69 @@
+#ifndef PARSEMD_BLOCKREADER_H_
+#define PARSEMD_BLOCKREADER_H_
+
+// Pull parsing over the top-level blocks of a document, for consumers that
+// only need its beginning, e.g. snippets and previews. A block is parsed,
+// block and inline pass, when it is pulled; whatever follows the last pulled
+// block is never looked at.
+//
+//   BlockReader reader(source);
+//   for (const Node& block : reader) {
+//     if (block->Type() == TokenType::Paragraph) break;
+//   }
+
+#include <iterator>
+
+#include "parser.h"
+
+namespace markdown {
+
+// Borrows source, which has to outlive the reader. Holds a parser of its own.
+template <Extension Ext>
+class BasicBlockReader {
+ public:
+  class Iterator {
+   public:
+    using iterator_category = std::input_iterator_tag;
+    using value_type = Node;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const Node*;
+    using reference = const Node&;
+
+    Iterator() = default;
+    explicit Iterator(BasicBlockReader* reader);
+
+    reference operator*() const;
+    pointer operator->() const;
+    Iterator& operator++();
+    bool operator==(const Iterator& other) const;
+    bool operator!=(const Iterator& other) const;
+
+   protected:
+    BasicBlockReader* reader_ = nullptr;
+    Node block_;
+  };
+
+  explicit BasicBlockReader(std::string_view source);
+  explicit BasicBlockReader(const PaddedString& source);
+  BasicBlockReader(const BasicBlockReader&) = delete;
+  BasicBlockReader& operator=(const BasicBlockReader&) = delete;
+
+  // Parses the next block, null once the source is done
+  Node Next();
+  // Bytes of the source consumed by the blocks pulled so far
+  size_t Offset() const;
+
+  // Continues from the last pulled block
+  Iterator begin();
+  Iterator end();
+
+ protected:
+  BasicParser<Ext> parser_;
+};
+
+using BlockReader = BasicBlockReader<dialect::GFM>;
+using CommonMarkBlockReader = BasicBlockReader<dialect::CommonMark>;
+
+}  // namespace markdown
+
+#endif  // !PARSEMD_BLOCKREADER_H_
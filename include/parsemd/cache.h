@@ -0,0 +1,63 @@
+#ifndef PARSEMD_CACHE_H_
+#define PARSEMD_CACHE_H_
+
+#include <list>
+#include <mutex>
+#include <unordered_map>
+
+#include "document.h"
+#include "types.h"
+
+namespace markdown {
+
+// Parse cache keyed by a 64-bit hash of the input, safe to use from many
+// threads. Entries live in independently locked shards, each evicting its
+// least recently used documents once it goes over its share of the byte
+// budget. Documents are immutable, evicted ones stay valid for as long as a
+// caller still holds them.
+class ParseCache {
+ public:
+  struct Stats {
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    uint64_t evictions = 0;
+    size_t entries = 0;
+    size_t bytes = 0;
+  };
+
+  ParseCache(size_t byteBudget = 64 << 20, size_t shards = 16);
+
+  // Cached document for source, parsed and inserted on a miss
+  SharedDocument Get(std::string_view source);
+  // Cached document for source or nullptr, never parses
+  SharedDocument Find(std::string_view source);
+  void Clear();
+  Stats GetStats() const;
+
+ protected:
+  struct Entry {
+    uint64_t hash;
+    SharedDocument doc;
+  };
+  using Lru = std::list<Entry>;
+
+  struct Shard {
+    mutable std::mutex mutex;
+    Lru lru;  // most recently used first
+    std::unordered_map<uint64_t, Lru::iterator> index;
+    size_t bytes = 0;
+    Stats stats = {};
+  };
+
+  std::unique_ptr<Shard[]> shards_;
+  size_t shardCount_;
+  size_t shardBudget_;
+
+  Shard& ShardFor(uint64_t hash);
+  SharedDocument Lookup(Shard& shard, uint64_t hash, std::string_view source);
+  void Evict(Shard& shard);
+};
+
+}  // namespace markdown
+
+#endif  // !PARSEMD_CACHE_H_
@@ -0,0 +1,62 @@
+#ifndef PARSEMD_CURSOR_H_
+#define PARSEMD_CURSOR_H_
+
+#include "types.h"
+
+namespace markdown {
+
+// Walks a tree in document order without recursion and without touching
+// reference counts. Containers are reported twice, on Enter and on Exit, text
+// nodes only once, on Enter:
+//
+//   for (Cursor c(root); c.Next();) {
+//     if (c.GetEvent() == Cursor::Enter) ... else ...
+//   }
+//
+// The stack holds one frame per open container, nodes deeper than maxDepth
+// are skipped and make Truncated() true. The tree must outlive the cursor and
+// not change while it is walked.
+class Cursor {
+ public:
+  enum Event : unsigned char { None, Enter, Exit };
+
+  static constexpr size_t defaultMaxDepth = 1 << 16;
+
+  Cursor(size_t maxDepth = defaultMaxDepth);
+  Cursor(const NodeBase& root, size_t maxDepth = defaultMaxDepth);
+  Cursor(const Node& root, size_t maxDepth = defaultMaxDepth);
+
+  // Restarts the walk at root, keeps the stack's capacity
+  void Reset(const NodeBase& root);
+  // Advances to the next event, false once the root has been exited
+  bool Next();
+
+  Event GetEvent() const;
+  const NodeBase& Current() const;
+  // Depth of Current(), the root is at 0
+  size_t Depth() const;
+  // Right after entering a container, makes its exit the next event
+  void SkipChildren();
+  bool Truncated() const;
+
+ protected:
+  struct Frame {
+    const ContainerNode* node;
+    const Node* next;
+    const Node* end;
+  };
+
+  std::vector<Frame> stack_;
+  const NodeBase* root_ = nullptr;
+  const NodeBase* node_ = nullptr;
+  size_t depth_ = 0;
+  size_t maxDepth_;
+  Event event_ = None;
+  bool truncated_ = false;
+
+  void EnterNode(const NodeBase* node, size_t depth);
+};
+
+}  // namespace markdown
+
+#endif  // !PARSEMD_CURSOR_H_
@@ -1,35 +1,44 @@
 #ifndef PARSEMD_DELIMITERSTACK_H_
 #define PARSEMD_DELIMITERSTACK_H_
 
+#include "internal.h"
 #include "types.h"
 
 namespace markdown {
 
 class DelimiterStack {
  public:
-  enum class Delimiter { Asteriks = 0, Underscore = 1 };
-  enum class DelimiterType { Open, Close, Both };
+  enum class DelimiterType : unsigned char { Open, Close, Both };
   struct DelimiterStackItem {
-    Delimiter delim;
-    size_t number;
-    bool isActive;
+    unsigned char kind;  // index into internal::delimiterRules
     DelimiterType type;
+    bool isActive;
+    size_t number;
     TokenList::iterator tokenIt;
   };
 
  public:
-  DelimiterStack();
+  DelimiterStack(std::pmr::memory_resource* resource =
+                     std::pmr::get_default_resource());
   void Push(DelimiterStackItem dsi);
   void Clear();
   void debug();
   bool ProcessEmphasis(TokenList& candTokens);
+  // Opener search steps since the last Clear, see ParseStats
+  uint64_t OpenerSteps() const;
 
  protected:
-  using DelimStack = std::list<DelimiterStackItem>;
+  using DelimStack = std::pmr::list<DelimiterStackItem>;
 
   DelimStack stack_;
   DelimStack::iterator dummy_, cur_, stackBottom_;
-  DelimStack::iterator openersBottom_[2];
+  DelimStack::iterator openersBottom_[internal::delimiterKinds];
+#ifdef PARSEMD_STATS
+  uint64_t openerSteps_ = 0;
+#endif
+
+  bool IsMatch(const DelimiterStackItem& opener,
+               const DelimiterStackItem& closer);
 };
 
 }  // namespace markdown
@@ -0,0 +1,64 @@
+#ifndef PARSEMD_DIAGNOSTICS_H_
+#define PARSEMD_DIAGNOSTICS_H_
+
+// Recoverable conditions met while parsing. They are recorded as a code and a
+// byte offset instead of being printed, so a parse never blocks on I/O.
+
+#include <functional>
+
+#include "types.h"
+
+namespace markdown {
+
+enum class DiagnosticCode : unsigned char {
+  EmptyDelimiterRun,  // a delimiter run without bytes, skipped
+  ScannerOverflow,    // flushed past the end of the input, clamped to it
+  UnhandledLine,      // a line no block claimed, dropped
+};
+std::string_view DiagnosticMessage(DiagnosticCode);
+
+struct Diagnostic {
+  static constexpr uint32_t noOffset = UINT32_MAX;
+
+  DiagnosticCode code;
+  uint32_t offset;  // into the document, noOffset if not within it
+};
+
+// Called for every report, also for those beyond the capacity
+using DiagnosticHandler = std::function<void(const Diagnostic&)>;
+
+// Diagnostics of one parse. Records are kept up to a fixed capacity, which is
+// reserved once, later ones are only counted and passed to the handler.
+class Diagnostics {
+ public:
+  static constexpr size_t defaultCapacity = 64;
+
+  Diagnostics(size_t capacity = defaultCapacity,
+              std::pmr::memory_resource* resource =
+                  std::pmr::get_default_resource());
+
+  // Offsets are taken relative to document from now on, records are cleared
+  void Begin(std::string_view document);
+  void Report(DiagnosticCode code, const char* at);
+  // Keeps the handler, the capacity and the document
+  void Clear();
+
+  void SetHandler(DiagnosticHandler handler);
+  void SetCapacity(size_t capacity);
+
+  const std::pmr::vector<Diagnostic>& Records() const;
+  // Reports that did not fit into the records
+  size_t Dropped() const;
+  bool Empty() const;
+
+ protected:
+  std::string_view document_;
+  std::pmr::vector<Diagnostic> records_;
+  size_t capacity_;
+  size_t dropped_ = 0;
+  DiagnosticHandler handler_;
+};
+
+}  // namespace markdown
+
+#endif  // !PARSEMD_DIAGNOSTICS_H_
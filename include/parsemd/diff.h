@@ -0,0 +1,34 @@
+#ifndef PARSEMD_DIFF_H_
+#define PARSEMD_DIFF_H_
+
+// Diffing two parses of a document by structural hash. Two subtrees with the
+// same hash are taken to be equal and never walked, so with the hashes kept by
+// the parser (PARSEMD_NODE_HASH) a diff costs about as much as it finds.
+
+#include "types.h"
+
+namespace markdown {
+
+// Top-level blocks [oldBegin, oldEnd) of the old root were replaced by
+// [newBegin, newEnd) of the new one. Either range may be empty.
+struct BlockChange {
+  size_t oldBegin;
+  size_t oldEnd;
+  size_t newBegin;
+  size_t newEnd;
+};
+
+// Stored hash of the node when built with PARSEMD_NODE_HASH, else computed
+// from its subtree
+uint64_t StructuralHash(const NodeBase& node);
+
+// Changed block ranges in document order. The common head and tail are
+// skipped first, the rest is matched up with Myers' O(ND) diff; past
+// maxEdits insertions and deletions it is reported as a single change.
+std::vector<BlockChange> DiffBlocks(const NodeBase& oldRoot,
+                                    const NodeBase& newRoot,
+                                    size_t maxEdits = 1024);
+
+}  // namespace markdown
+
+#endif  // !PARSEMD_DIFF_H_
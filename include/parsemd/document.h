@@ -0,0 +1,110 @@
+#ifndef PARSEMD_DOCUMENT_H_
+#define PARSEMD_DOCUMENT_H_
+
+#include <mutex>
+
+#include "types.h"
+
+namespace markdown {
+
+// Result of a parse that owns everything it refers to, including the source
+// the node offsets point into. It only hands out const access and is never
+// modified after construction, so it can be shared between threads.
+class Document {
+ public:
+  Document();
+  Document(Node root, std::string source);
+  // source stays valid for as long as owner is alive, e.g. a MappedFile.
+  // ownerBytes is the heap memory owner holds, counted in Bytes().
+  Document(Node root,
+           std::string_view source,
+           std::shared_ptr<const void> owner,
+           size_t ownerBytes = 0);
+
+  const NodeBase& Root() const;
+  std::string_view Source() const;
+  // Approximate heap footprint, used for cache budgets
+  size_t Bytes() const;
+
+ protected:
+  Node root_;
+  std::string_view source_;
+  std::shared_ptr<const void> owner_;
+  size_t bytes_ = 0;
+
+  void AddNodeBytes();
+};
+
+using SharedDocument = std::shared_ptr<const Document>;
+
+// Reentrant parse entry point. Scratch state lives in a hidden per-thread
+// parser, so this can be called from any number of threads at once and the
+// returned document can be shared freely.
+template <Extension Ext = dialect::GFM>
+Document Parse(std::string_view source);
+
+extern template Document Parse<dialect::CommonMark>(std::string_view);
+extern template Document Parse<dialect::GFM>(std::string_view);
+
+// Parses a file straight out of a read-only mapping of it, which the returned
+// document keeps alive. Throws std::system_error if the file cannot be mapped.
+template <Extension Ext = dialect::GFM>
+Document ParseFile(const std::string& path);
+
+extern template Document ParseFile<dialect::CommonMark>(const std::string&);
+extern template Document ParseFile<dialect::GFM>(const std::string&);
+
+// Only scans the block structure of source, see LazyDocument
+template <Extension Ext = dialect::GFM>
+LazyDocument ParseLazy(std::string_view source);
+
+// Document whose inline content is only parsed when asked for, one top-level
+// block at a time. Blocks() is the bare block structure, with RawText on
+// every block, and never changes. At() and Root() hand out copies of the
+// blocks with their inline children, each built exactly once, by whichever
+// thread asks first, so the document can be shared between threads.
+class LazyDocument {
+ public:
+  LazyDocument();
+
+  const NodeBase& Blocks() const;
+  // Number of top-level blocks
+  size_t Size() const;
+  // Top-level block i with its inline children
+  const NodeBase& At(size_t i) const;
+  // Whole tree, parses every block not parsed yet
+  const NodeBase& Root() const;
+  std::string_view Source() const;
+
+  template <Extension Ext>
+  friend LazyDocument ParseLazy(std::string_view source);
+
+ protected:
+  // Runs inline analysis on a block copy whose text points into source
+  using Expander = void (*)(std::string_view source, const Block& block);
+
+  struct Slot {
+    std::once_flag once;
+    Node node;
+  };
+
+  Node blocks_;
+  std::string_view source_;
+  std::shared_ptr<const void> owner_;
+  Expander expand_ = nullptr;
+  std::unique_ptr<Slot[]> slots_;
+  std::unique_ptr<Slot> root_;
+
+  LazyDocument(Node blocks,
+               std::string_view source,
+               std::shared_ptr<const void> owner,
+               Expander expand);
+  static Block CopyBlock(const BlockNode& block);
+};
+
+extern template LazyDocument ParseLazy<dialect::CommonMark>(std::string_view);
+extern template LazyDocument ParseLazy<dialect::GFM>(std::string_view);
+
+}  // namespace markdown
+
+#endif  // !PARSEMD_DOCUMENT_H_
@@ -0,0 +1,70 @@
+#ifndef PARSEMD_FLATTREE_H_
+#define PARSEMD_FLATTREE_H_
+
+// Compact copy of a parsed tree for read-heavy passes. Nodes are 16-byte
+// records in one array, in document (pre)order, so visiting every node is a
+// linear sweep. The subtree of node i is the index range [i, end), its first
+// child is i + 1 when that is inside the range and the next sibling is end
+// when the node there has the same depth.
+
+#include "types.h"
+
+namespace markdown {
+
+struct FlatNode {
+  uint32_t text;      // offset into FlatTree::Strings
+  uint32_t textSize;
+  uint32_t end;       // one past the last node of the subtree
+  uint16_t depth;     // root is at 0
+  uint8_t type;       // TokenType
+  uint8_t align;      // Alignment, table cells only
+};
+static_assert(sizeof(FlatNode) == 16);
+
+class FlatTree {
+ public:
+  static constexpr uint32_t npos = UINT32_MAX;
+  // Deeper nodes are dropped while flattening and make Truncated() true,
+  // e.g. for a tree parsed with a ParseLimits::maxDepth above it
+  static constexpr size_t maxDepth = UINT16_MAX;
+
+  FlatTree();
+  // typeColumn also keeps the types in an array of their own (see Types)
+  FlatTree(const NodeBase& root, bool typeColumn = false);
+  FlatTree(const Node& root, bool typeColumn = false);
+  void Build(const NodeBase& root, bool typeColumn = false);
+  void Clear();
+
+  size_t Size() const;
+  // Whether nodes deeper than maxDepth were dropped
+  bool Truncated() const;
+  const std::vector<FlatNode>& Nodes() const;
+  const FlatNode& operator[](uint32_t index) const;
+
+  TokenType Type(uint32_t index) const;
+  Alignment Align(uint32_t index) const;
+  std::string_view Text(uint32_t index) const;
+  // Empty range unless built with PARSEMD_SOURCE_POS
+  SourceRange Source(uint32_t index) const;
+  // npos when there is none
+  uint32_t FirstChild(uint32_t index) const;
+  uint32_t NextSibling(uint32_t index) const;
+
+  // One TokenType byte per node for scans that only look at types, empty
+  // unless built with typeColumn
+  const std::vector<uint8_t>& Types() const;
+  std::string_view Strings() const;
+
+ protected:
+  std::vector<FlatNode> nodes_;
+  std::vector<uint8_t> types_;
+  std::string strings_;
+  bool truncated_ = false;
+#ifdef PARSEMD_SOURCE_POS
+  std::vector<SourceRange> sources_;
+#endif
+};
+
+}  // namespace markdown
+
+#endif  // !PARSEMD_FLATTREE_H_
@@ -0,0 +1,237 @@
+#ifndef PARSEMD_HTML_H_
+#define PARSEMD_HTML_H_
+
+// HTML rendering of the AST, in the shape of the GFM spec's output:
+//   <h1>Title</h1>
+//   <p>Some <em>text</em></p>
+//   <table>
+//   <thead>
+//   <tr>
+//   <th align="left">a</th>
+//   </tr>
+//   </thead>
+//   <tbody>
+//   ...
+// Text is escaped, a softbreak is a newline.
+
+#include <functional>
+
+#include "cursor.h"
+#include "types.h"
+
+namespace markdown {
+
+namespace internal {
+
+// What a byte of text is written as, empty when it is written as is
+constexpr std::string_view HtmlEscape(char c) {
+  switch (c) {
+    case '&':
+      return "&amp;";
+    case '<':
+      return "&lt;";
+    case '>':
+      return "&gt;";
+    case '"':
+      return "&quot;";
+    default:
+      return {};
+  }
+}
+
+// The markup around the text, for the nodes in document order. Shared by
+// HtmlWriter and the literal renderer of static.h, which cannot use a Cursor.
+// Append is called with the markup.
+class HtmlMarkup {
+ public:
+  constexpr void Reset() { head_ = body_ = newline_ = false; }
+
+  template <typename Append>
+  constexpr void Open(TokenType type, Alignment align, Append&& append) {
+    bool newline = newline_;
+    newline_ = false;
+    if (IsHeading(type)) {
+      append(headingOpen[static_cast<int>(type) -
+                         static_cast<int>(TokenType::H1)]);
+      return;
+    }
+    switch (type) {
+      case TokenType::Paragraph:
+        append("<p>");
+        break;
+      case TokenType::Codeblock:
+        append("<pre><code>");
+        break;
+      case TokenType::Table:
+        append("<table>\n");
+        break;
+      case TokenType::TableHead:
+        head_ = true;
+        append("<thead>\n<tr>\n");
+        break;
+      case TokenType::TableRow:
+        if (!body_) {
+          body_ = true;
+          append("<tbody>\n");
+        }
+        append("<tr>\n");
+        break;
+      case TokenType::TableCell:
+        append(head_ ? "<th" : "<td");
+        append(AlignAttribute(align));
+        append(">");
+        break;
+      case TokenType::Strong:
+        append("<strong>");
+        break;
+      case TokenType::Emph:
+        append("<em>");
+        break;
+      case TokenType::StrongEmph:
+        append("<em><strong>");
+        break;
+      case TokenType::Strikethrough:
+        append("<del>");
+        break;
+      case TokenType::Code:
+        append("<code>");
+        break;
+      case TokenType::Softbreak:
+        // the text before a softbreak keeps its newline, unless it ends in
+        // markup
+        if (!newline) {
+          append("\n");
+        }
+        break;
+      default:
+        break;
+    }
+  }
+
+  template <typename Append>
+  constexpr void Close(TokenType type, Append&& append) {
+    newline_ = false;
+    if (IsHeading(type)) {
+      append(headingClose[static_cast<int>(type) -
+                          static_cast<int>(TokenType::H1)]);
+      return;
+    }
+    switch (type) {
+      case TokenType::Paragraph:
+        append("</p>\n");
+        break;
+      case TokenType::Codeblock:
+        append("</code></pre>\n");
+        break;
+      case TokenType::Table:
+        if (body_) {
+          body_ = false;
+          append("</tbody>\n");
+        }
+        append("</table>\n");
+        break;
+      case TokenType::TableHead:
+        head_ = false;
+        append("</tr>\n</thead>\n");
+        break;
+      case TokenType::TableRow:
+        append("</tr>\n");
+        break;
+      case TokenType::TableCell:
+        append(head_ ? "</th>\n" : "</td>\n");
+        break;
+      case TokenType::Strong:
+        append("</strong>");
+        break;
+      case TokenType::Emph:
+        append("</em>");
+        break;
+      case TokenType::StrongEmph:
+        append("</strong></em>");
+        break;
+      case TokenType::Strikethrough:
+        append("</del>");
+        break;
+      case TokenType::Code:
+        append("</code>");
+        break;
+      default:
+        break;
+    }
+  }
+
+  // After the escaped text of a TextNode
+  constexpr void Text(std::string_view text) {
+    newline_ = !text.empty() && text.back() == '\n';
+  }
+
+ protected:
+  static constexpr std::string_view headingOpen[] = {
+      "<h1>", "<h2>", "<h3>", "<h4>", "<h5>", "<h6>"};
+  static constexpr std::string_view headingClose[] = {
+      "</h1>\n", "</h2>\n", "</h3>\n", "</h4>\n", "</h5>\n", "</h6>\n"};
+
+  // inside a TableHead, its cells are <th>
+  bool head_ = false;
+  // a <tbody> is open in the current table
+  bool body_ = false;
+  // the last text written ended in a newline
+  bool newline_ = false;
+
+  static constexpr std::string_view AlignAttribute(Alignment align) {
+    switch (align) {
+      case Alignment::Left:
+        return " align=\"left\"";
+      case Alignment::Center:
+        return " align=\"center\"";
+      case Alignment::Right:
+        return " align=\"right\"";
+      default:
+        return "";
+    }
+  }
+};
+
+}  // namespace internal
+
+// Receives the output in chunks of roughly the writer's buffer size
+using HtmlSink = std::function<void(std::string_view)>;
+
+// Streams HTML into a sink like JsonWriter: one buffer kept between calls and
+// an unbounded Cursor for the walk.
+class HtmlWriter {
+ public:
+  HtmlWriter(HtmlSink sink, size_t bufferSize = 64 << 10);
+
+  // Writes the tree and flushes everything to the sink
+  void Write(const NodeBase& root);
+  void Write(const Node& root);
+
+ protected:
+  HtmlSink sink_;
+  size_t bufferSize_;
+  std::string buffer_;
+  Cursor cursor_;
+  internal::HtmlMarkup markup_;
+
+  void Append(std::string_view sv);
+  void AppendEscaped(std::string_view sv);
+  void Flush();
+};
+
+// Whole document as one string
+void ToHtml(const NodeBase& root, std::string& out);
+std::string ToHtml(const Node& root);
+
+// The root's blocks rendered on up to `threads` threads, in contiguous runs
+// that are handed out as threads become free. The chunks in order are
+// byte-identical to ToHtml, e.g. for a gathered write. A single chunk when
+// threads is 1 or root is not a Root. An exception on any of the threads is
+// rethrown on the calling one once all of them are done.
+std::vector<std::string> ToHtmlChunks(const NodeBase& root, size_t threads);
+// ToHtmlChunks copied into out
+void ToHtmlParallel(const NodeBase& root, std::string& out, size_t threads);
+
+}  // namespace markdown
+
+#endif  // !PARSEMD_HTML_H_
@@ -1,6 +1,9 @@
 #ifndef PARSEMD_INTERNAL_H_
 #define PARSEMD_INTERNAL_H_
 
+#include <array>
+#include <iterator>
+
 #include "types.h"
 
 namespace markdown {
@@ -19,18 +22,172 @@ inline constexpr Marker markers[] = {
     {"#", TokenType::H1},           {"##", TokenType::H2},
     {"###", TokenType::H3},         {"####", TokenType::H4},
     {"#####", TokenType::H5},       {"######", TokenType::H6},
-    {"\n", TokenType::Softbreak},
+    {"\n", TokenType::Softbreak},   {"~~", TokenType::Strikethrough},
+    {"~", TokenType::Strikethrough},
+};
+
+// Delimiter runs
+// https://spec.commonmark.org/0.31.2/#delimiter-run
+// A run of length >= 2 closes with `twice` and consumes two delimiters, a
+// shorter one with `single`. `exactLength` runs only match a run of the same
+// length and are consumed whole, runs longer than `maxRun` are plain text.
+struct DelimiterRule {
+  char delim;
+  TokenType single;
+  TokenType twice;
+  bool intraword;      // false: `_` rules for left/right flanking runs
+  bool ruleOfThree;    // the "multiple of 3" rule
+  bool exactLength;
+  unsigned char maxRun;  // 0 for unbounded
 };
 
+// clang-format off
+inline constexpr DelimiterRule delimiterRules[] = {
+  {'*', TokenType::Emph,          TokenType::Strong,        true,  true,  false, 0},
+  {'_', TokenType::Emph,          TokenType::Strong,        false, true,  false, 0},
+  {'~', TokenType::Strikethrough, TokenType::Strikethrough, true,  false, true,  2},
+};
+// clang-format on
+inline constexpr size_t delimiterKinds = std::size(delimiterRules);
+
+constexpr bool IsDelimiterEnabled(Extension ext, char delim) {
+  return delim != '~' || HasExtension(ext, Extension::Strikethrough);
+}
+
+// Index into delimiterRules for every byte, -1 for non delimiters. Built per
+// dialect, so disabled delimiters cost nothing in the inline byte loop.
+template <Extension Ext>
+constexpr std::array<signed char, 256> MakeDelimiterKinds() {
+  std::array<signed char, 256> kinds = {};
+  for (signed char& kind : kinds) {
+    kind = -1;
+  }
+  for (size_t i = 0; i < delimiterKinds; i++) {
+    if (IsDelimiterEnabled(Ext, delimiterRules[i].delim)) {
+      kinds[static_cast<unsigned char>(delimiterRules[i].delim)] = i;
+    }
+  }
+  return kinds;
+}
+template <Extension Ext>
+inline constexpr std::array<signed char, 256> delimiterKind =
+    MakeDelimiterKinds<Ext>();
+
 TokenType GetMarker(std::string_view str);
-bool IsDelimiter(char c);
-bool IsValidDelimiter(char prev, char delim, char next);
-bool IsWhitespace(char);
-bool IsPunctuation(char);
-bool IsLeftFlanking(char prev, char next);
-bool IsRightFlanking(char prev, char next);
-
-void htrim(std::string_view& sv);
+
+// The byte classes below are constexpr for the literal parser of static.h
+
+constexpr bool IsDelimiter(char c) {
+  for (const DelimiterRule& rule : delimiterRules) {
+    if (rule.delim == c)
+      return true;
+  }
+  return false;
+}
+
+constexpr bool IsWhitespace(char c) {
+  return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+constexpr bool IsPunctuation(char c) {
+  // ASCII only
+  return (c >= 33 && c <= 47) || (c >= 58 && c <= 64) ||
+         (c >= 91 && c <= 96) || (c >= 123 && c <= 126);
+}
+
+constexpr bool IsLeftFlanking(char prev, char next) {
+  // NOTE: No Unicode support
+  if (IsWhitespace(next)) {
+    return false;
+  }
+
+  if (IsPunctuation(next) && !(IsWhitespace(prev) || IsPunctuation(prev))) {
+    return false;
+  }
+
+  return true;
+}
+
+constexpr bool IsRightFlanking(char prev, char next) {
+  // NOTE: No Unicode support
+  if (IsWhitespace(prev)) {
+    return false;
+  }
+
+  if (IsPunctuation(prev) && !(IsWhitespace(next) || IsPunctuation(next))) {
+    return false;
+  }
+
+  return true;
+}
+
+constexpr bool IsValidDelimiter(char prev, char delim, char next) {
+  if (!IsDelimiter(delim)) {
+    return false;
+  }
+
+  return IsLeftFlanking(prev, next) || IsRightFlanking(prev, next);
+}
+
+constexpr void htrim(std::string_view& sv) {
+  size_t count = 0;
+  while (count != sv.size() && IsWhitespace(sv[count])) {
+    count++;
+  }
+  sv.remove_prefix(count);
+
+  count = sv.size();
+  while (count != 0 && IsWhitespace(sv[count - 1])) {
+    count--;
+  }
+  sv.remove_suffix(sv.size() - count);
+}
+
+// Fast non-cryptographic 64-bit hashing
+uint64_t Hash64(std::string_view data, uint64_t seed = 0);
+uint64_t HashCombine(uint64_t seed, uint64_t value);
+// Hash of a node without its children: type, alignment and own text. The
+// structural hash combines it with the children's hashes in order.
+uint64_t NodeSeedHash(const NodeBase& node);
+
+// GFM tables
+// Cells are written into the caller's vector, which is cleared but keeps its
+// capacity, so splitting rows does not allocate once it has warmed up.
+
+// A pipe is escaped when it is preceded by an odd number of backslashes
+constexpr bool IsEscaped(std::string_view sv, size_t pos) {
+  size_t count = 0;
+  while (pos > count && sv[pos - count - 1] == '\\') {
+    count++;
+  }
+  return count % 2;
+}
+
+// One cell of a delimiter row, e.g. `:--`. False when it is not one.
+constexpr bool ParseTableDelimiterCell(std::string_view cell,
+                                       Alignment& align) {
+  bool left = !cell.empty() && cell.front() == ':';
+  bool right = cell.size() > left && cell.back() == ':';
+  cell.remove_prefix(left);
+  cell.remove_suffix(right);
+  if (cell.empty() || cell.find_first_not_of('-') != std::string_view::npos) {
+    return false;
+  }
+
+  align = (left && right) ? Alignment::Center
+          : left          ? Alignment::Left
+          : right         ? Alignment::Right
+                          : Alignment::None;
+  return true;
+}
+
+size_t FindTablePipe(std::string_view row, size_t pos = 0);
+void SplitTableRow(std::string_view row,
+                   std::pmr::vector<std::string_view>& cells);
+bool ParseTableDelimiterRow(std::string_view row,
+                            std::pmr::vector<std::string_view>& cells,
+                            std::pmr::vector<Alignment>& aligns);
+
 TokenList::iterator listIteratorAdvance(TokenList::iterator& it, int inc);
 
 }  // namespace internal
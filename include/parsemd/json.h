@@ -0,0 +1,51 @@
+#ifndef PARSEMD_JSON_H_
+#define PARSEMD_JSON_H_
+
+// JSON export of the AST. Every node becomes
+//   {"type":"Paragraph","text":"...","align":"left","source":[0,12],
+//    "children":[...]}
+// where text is only present when non-empty, align only on aligned table
+// cells, source only when built with PARSEMD_SOURCE_POS and children on every
+// non-text node.
+
+#include <functional>
+
+#include "cursor.h"
+#include "types.h"
+
+namespace markdown {
+
+// Receives the output in chunks of roughly the writer's buffer size
+using JsonSink = std::function<void(std::string_view)>;
+
+// Streams JSON into a sink through one buffer that is kept between calls, so
+// writing many documents with the same writer does not allocate. The tree is
+// walked with an unbounded Cursor, its depth is not bound by the call stack.
+class JsonWriter {
+ public:
+  JsonWriter(JsonSink sink, size_t bufferSize = 64 << 10);
+
+  // Writes the tree and flushes everything to the sink
+  void Write(const NodeBase& root);
+  void Write(const Node& root);
+
+ protected:
+  JsonSink sink_;
+  size_t bufferSize_;
+  std::string buffer_;
+  Cursor cursor_;
+
+  bool Open(const NodeBase& node);
+  void Append(std::string_view sv);
+  void AppendEscaped(std::string_view sv);
+  void AppendNumber(uint32_t value);
+  void Flush();
+};
+
+// Whole document as one string
+void ToJson(const NodeBase& root, std::string& out);
+std::string ToJson(const Node& root);
+
+}  // namespace markdown
+
+#endif  // !PARSEMD_JSON_H_
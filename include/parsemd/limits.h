@@ -0,0 +1,55 @@
+#ifndef PARSEMD_LIMITS_H_
+#define PARSEMD_LIMITS_H_
+
+// Bounds on a single parse of untrusted input. Hitting one never fails the
+// parse, it stops early with a partial tree and reports which limit it was,
+// see BasicParser::Truncated.
+
+#include <atomic>
+#include <chrono>
+
+#include "types.h"
+
+namespace markdown {
+
+struct ParseLimits {
+  using Clock = std::chrono::steady_clock;
+
+  enum Limit : unsigned char {
+    None,
+    InputSize,
+    Depth,
+    Tokens,
+    Delimiters,
+    Nodes,
+    Deadline,
+    Cancelled,
+  };
+
+  // Inline containers are built recursively, and trees are freed that way.
+  // Deeper nesting than this would risk overflowing a thread's stack.
+  static constexpr size_t defaultMaxDepth = 1000;
+
+  // Longer input is cut after its last line break within the limit
+  size_t maxInputSize = SIZE_MAX;
+  // Emphasis nested deeper is kept as literal text
+  size_t maxDepth = defaultMaxDepth;
+  // Per block, the rest of the block is kept as literal text
+  size_t maxTokens = SIZE_MAX;
+  // Per block, later delimiter runs are literal text
+  size_t maxDelimiters = SIZE_MAX;
+
+  // Checked at block boundaries along with deadline and cancel. Blocks not
+  // reached are dropped, so the tree only holds completely parsed blocks and
+  // can exceed maxNodes by the nodes of one block.
+  size_t maxNodes = SIZE_MAX;
+  Clock::time_point deadline = Clock::time_point::max();
+  // Set by another thread to stop the parse
+  const std::atomic<bool>* cancel = nullptr;
+
+  static std::string_view LimitName(Limit limit);
+};
+
+}  // namespace markdown
+
+#endif  // !PARSEMD_LIMITS_H_
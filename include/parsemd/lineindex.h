@@ -0,0 +1,32 @@
+#ifndef PARSEMD_LINEINDEX_H_
+#define PARSEMD_LINEINDEX_H_
+
+#include "types.h"
+
+namespace markdown {
+
+// Maps byte offsets of a document (see NodeBase::Source) to lines and columns.
+// Building is a single pass over the document, lookups are O(log lines).
+class LineIndex {
+ public:
+  // 1-based line, 1-based byte column
+  struct Position {
+    uint32_t line;
+    uint32_t column;
+  };
+
+  LineIndex();
+  LineIndex(std::string_view doc);
+  void Init(std::string_view doc);
+
+  Position Locate(uint32_t offset) const;
+  uint32_t LineBegin(uint32_t line) const;
+  size_t Lines() const;
+
+ protected:
+  std::vector<uint32_t> lineBegins_;
+};
+
+}  // namespace markdown
+
+#endif  // !PARSEMD_LINEINDEX_H_
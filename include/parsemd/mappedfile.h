@@ -0,0 +1,37 @@
+#ifndef PARSEMD_MAPPEDFILE_H_
+#define PARSEMD_MAPPEDFILE_H_
+
+#include <string>
+#include <string_view>
+
+namespace markdown {
+
+// Read-only memory mapping of a whole file, unmapped on destruction
+class MappedFile {
+ public:
+  MappedFile();
+  MappedFile(const std::string& path, bool sequential = false);
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+  MappedFile(MappedFile&& other) noexcept;
+  MappedFile& operator=(MappedFile&& other) noexcept;
+  ~MappedFile();
+
+  // false on failure, errno is left as set by open/fstat/mmap. sequential
+  // tells the kernel the file is read front to back, for aggressive readahead.
+  bool Open(const std::string& path, bool sequential = false);
+  void Close();
+  bool IsOpen() const;
+
+  std::string_view View() const;
+  size_t Size() const;
+
+ protected:
+  const char* data_ = nullptr;
+  size_t size_ = 0;
+  bool open_ = false;
+};
+
+}  // namespace markdown
+
+#endif  // !PARSEMD_MAPPEDFILE_H_
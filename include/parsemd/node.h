@@ -8,35 +8,67 @@ namespace markdown {
 struct NodeBase {
   NodeBase(TokenType type);
   TokenType Type() const;
+  // Empty range unless built with PARSEMD_SOURCE_POS
+  SourceRange Source() const;
+  // Structural hash of the node and its subtree, kept up to date by the
+  // parser when built with PARSEMD_NODE_HASH and 0 otherwise, see
+  // StructuralHash
+  uint64_t Hash() const;
 
-  friend class Parser;
+  template <Extension>
+  friend class BasicParser;
+  friend class LazyDocument;
 
  private:
   TokenType type_;
+#ifdef PARSEMD_SOURCE_POS
+  SourceRange source_ = {};
+#endif
+#ifdef PARSEMD_NODE_HASH
+  uint64_t hash_ = 0;
+#endif
 };
 
+// Nodes take the memory resource of their children and text, the parser
+// passes its own
 struct ContainerNode : public NodeBase {
-  ContainerNode(TokenType type);
-  Nodes children = {};
+  ContainerNode(TokenType type, std::pmr::memory_resource* resource =
+                                    std::pmr::get_default_resource());
+  Nodes children;
 };
 
 struct BlockNode : public ContainerNode {
   BlockNode();
-  BlockNode(TokenType type);
+  BlockNode(TokenType type, std::pmr::memory_resource* resource =
+                                std::pmr::get_default_resource());
+  // Block text still waiting for inline analysis, empty once analyzed
+  std::string_view RawText() const;
 
-  friend class Parser;
+  template <Extension>
+  friend class BasicParser;
+  friend class LazyDocument;
 
  private:
   std::string_view text_;
 };
 
+struct TableCellNode : public BlockNode {
+  TableCellNode(Alignment align, std::pmr::memory_resource* resource =
+                                     std::pmr::get_default_resource());
+  Alignment align;
+};
+
 struct InlineNode : public ContainerNode {
-  InlineNode(TokenType type);
+  InlineNode(TokenType type, std::pmr::memory_resource* resource =
+                                 std::pmr::get_default_resource());
 };
 
 struct TextNode : public NodeBase {
-  TextNode(TokenType type, std::string text);
-  std::string text;
+  TextNode(TokenType type,
+           std::string_view text,
+           std::pmr::memory_resource* resource =
+               std::pmr::get_default_resource());
+  std::pmr::string text;
 };
 
 // Node Downcast helpers
@@ -44,13 +76,26 @@ Container ContainerNodePtr(Node node);
 Block BlockNodePtr(Node node);
 Inline InlineNodePtr(Node node);
 Text TextNodePtr(Node node);
+TableCell TableCellNodePtr(Node node);
+
+// Const downcast helpers for read-only trees (see Document), nullptr on
+// mismatch
+const ContainerNode* ContainerNodePtr(const NodeBase* node);
+const BlockNode* BlockNodePtr(const NodeBase* node);
+const InlineNode* InlineNodePtr(const NodeBase* node);
+const TextNode* TextNodePtr(const NodeBase* node);
+const TableCellNode* TableCellNodePtr(const NodeBase* node);
 
 inline bool IsHeading(Node node) {
   return node && node->Type() >= TokenType::H1 && node->Type() <= TokenType::H6;
 }
 inline bool IsBlock(Node node) {
   return node && node->Type() >= TokenType::Root &&
-         node->Type() <= TokenType::H6;
+         node->Type() <= TokenType::TableCell;
+}
+inline bool IsTable(Node node) {
+  return node && node->Type() >= TokenType::Table &&
+         node->Type() <= TokenType::TableCell;
 }
 inline bool IsInline(Node node) {
   return node && node->Type() > TokenType::Text &&
@@ -0,0 +1,52 @@
+#ifndef PARSEMD_PADDED_H_
+#define PARSEMD_PADDED_H_
+
+// Input buffer with zero bytes after its end, so the scanner can read ahead
+// of a position without checking for the end of the data first.
+
+#include <memory_resource>
+
+#include "types.h"
+
+namespace markdown {
+
+// Owns a copy of a string, followed by `padding` zero bytes and preceded by
+// one. Assigning keeps the buffer when it is large enough. The buffer comes
+// from the given memory resource; copies use the default one, moves carry
+// the resource along with the buffer.
+class PaddedString {
+ public:
+  static constexpr size_t padding = 64;
+
+  PaddedString();
+  explicit PaddedString(std::pmr::memory_resource* resource);
+  explicit PaddedString(std::string_view str,
+                        std::pmr::memory_resource* resource =
+                            std::pmr::get_default_resource());
+  PaddedString(const PaddedString& other);
+  PaddedString(PaddedString&& other) noexcept;
+  PaddedString& operator=(const PaddedString& other);
+  PaddedString& operator=(PaddedString&& other) noexcept;
+  ~PaddedString();
+
+  void Assign(std::string_view str);
+  void Clear();
+
+  const char* data() const;
+  size_t size() const;
+  bool empty() const;
+  std::string_view View() const;
+  operator std::string_view() const;
+
+ protected:
+  std::pmr::memory_resource* resource_;
+  char* buffer_ = nullptr;
+  size_t size_ = 0;
+  size_t capacity_ = 0;
+
+  void Free();
+};
+
+}  // namespace markdown
+
+#endif  // !PARSEMD_PADDED_H_
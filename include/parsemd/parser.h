@@ -5,47 +5,129 @@
 // https://spec.commonmark.org/0.31.2/#appendix-a-parsing-strategy
 
 #include "delimiterstack.h"
+#include "diagnostics.h"
+#include "limits.h"
+#include "padded.h"
 #include "scanner.h"
+#include "stats.h"
 #include "types.h"
 
 namespace markdown {
 
-class Parser {
+// Parser for CommonMark plus the extensions in Ext. Only the dialects in
+// markdown::dialect are instantiated, see Parser and CommonMarkParser.
+template <Extension Ext>
+class BasicParser {
  public:
-  Parser();
+  BasicParser();
+  // Every allocation of the parser and of the trees it builds comes from
+  // resource: tokens, delimiters, nodes, their children and text, and the
+  // document copy. resource has to outlive the parser and every tree, e.g. a
+  // per-request std::pmr::monotonic_buffer_resource.
+  explicit BasicParser(std::pmr::memory_resource* resource);
+  std::pmr::memory_resource* Resource() const;
 
   void AssignDocument(std::string_view);
+  // Like AssignDocument without the copy, doc has to outlive the parse
+  void BorrowDocument(std::string_view);
+  // Borrowed too, its padding lets the inline scan skip end of data checks
+  void BorrowDocument(const PaddedString&);
   void AnalyzeBlocks(std::string_view);
   void AnalyzeBlocks();
   Node BuildBlocks();
   Node BuildParagraphBlock();
+  Node BuildTableBlock(std::string_view header);
   Node GetBlock();
 
   // void Tokenize(std::string_view);
   // void LexAnalysis();
   Node Parse();
   Node Parse(std::string_view);
+  Node Parse(const PaddedString&);
   Node GetRoot();
+  // Pull parsing of the assigned document: the next top-level block with its
+  // inlines, null at the end. No root is built, see BlockReader.
+  Node NextBlock();
+  // Bytes of the document consumed by the blocks pulled with NextBlock
+  size_t BlockOffset() const;
+  // Drops the document and tree, keeps the scratch buffers for the next parse
+  void Reset();
 
   TokenList GetTokens();
 
+  // Totals since the last ClearStats, all zero unless built with PARSEMD_STATS
+  const ParseStats& Stats() const;
+  void ClearStats(bool trace = false);
+
+  // Of the current parse, cleared whenever a document is assigned
+  const Diagnostics& GetDiagnostics() const;
+  void SetDiagnosticHandler(DiagnosticHandler handler);
+
+  // Apply to every following parse
+  void SetLimits(const ParseLimits& limits);
+  const ParseLimits& Limits() const;
+  // First limit the current parse hit, None for a complete tree
+  ParseLimits::Limit Truncated() const;
+
   DelimiterStack delimStack = {};
   void AnalyzeInline();
+  void AnalyzeInline(const Block&);
   void PushCandToken();
   void PushCandToken(size_t);
   Node BuildInline(TokenList::iterator it);
 
   // static std::string DumpTree(const Tree&, int = 0);
   static std::string DumpTree(const Node&, int = 0);
+  // Appends the dump to out, iteratively, so depth is not bound by the stack
+  static void DumpTree(const NodeBase&, std::string& out, int = 0);
 
  private:
-  enum class BlockType { Root, Paragraph, Heading };
+  enum class BlockType { Root, Paragraph, Heading, Table };
+
+  TokenType HeadingType(std::string_view line, size_t pos, int& count);
+  bool IsTableStart(std::string_view line);
+  Node BuildTableRow(TokenType type, std::string_view line);
+  void SetSource(NodeBase& node, std::string_view span);
+  // Structural hash from the children's, which have to be hashed already
+  void SetHash(NodeBase& node);
+  // Block with its table rows and cells, before the inline pass
+  void HashBlocks(NodeBase& node);
+  std::string_view LimitInput(std::string_view doc);
+  void Truncate(ParseLimits::Limit limit);
+  // Nodes, deadline and cancellation, checked between blocks
+  bool LimitReached();
+  void FlattenInline(TokenList::iterator it);
+  template <bool Padded>
+  void ScanInline(std::string_view text);
+  void PushDelimiterRun(size_t count, char prev, char next);
+  template <typename T, typename... Args>
+  std::shared_ptr<T> NewNode(Args&&... args);
 
-  std::string document_;
+  std::pmr::memory_resource* resource_;
+  std::string_view document_;
+  PaddedString storage_;
+  // document_ lies in a PaddedString
+  bool padded_ = false;
   Scanner scanner = {};
   TokenList candTokens_ = {};
   std::shared_ptr<BlockNode> block_ = {};
   BlockType blockType_ = BlockType::Root;
+
+  // scratch for table rows, reused across rows and tables
+  std::pmr::vector<std::string_view> cells_ = {};
+  std::pmr::vector<Alignment> aligns_ = {};
+
+  Diagnostics diagnostics_ = {};
+
+  ParseLimits limits_ = {};
+  ParseLimits::Limit truncated_ = ParseLimits::None;
+  size_t nodes_ = 0;
+  size_t depth_ = 0;
+  size_t delimiters_ = 0;
+
+#ifdef PARSEMD_STATS
+  ParseStats stats_ = {};
+#endif
 };
 
 }  // namespace markdown
@@ -1,21 +1,30 @@
 #ifndef PARSEMD_SCANNER_H_
 #define PARSEMD_SCANNER_H_
 
+#include <algorithm>
+
 #include "types.h"
 
 namespace markdown {
 
+class Diagnostics;
+
 class Scanner {
  public:
   enum class CurPos { Begin, BeginIt, Cur, EndIt, End };
-  friend class Parser;
+  template <Extension>
+  friend class BasicParser;
   Scanner();
   Scanner(std::string_view data);
   void Init(std::string_view data);
+  // Receives the overflows, which are silently clamped without it
+  void SetDiagnostics(Diagnostics* diagnostics);
   char ScanNextByte();
   char CurrentByte();
   std::string_view ScanNextLine();
   std::string_view CurrentLine();
+  std::string_view PeekNextLine();
+  void UnscanLine();
   std::string_view FlushCurrentLine();
   void Flush();
   void FlushBytes(size_t n);
@@ -29,16 +38,49 @@ class Scanner {
                         int offset = 0);
   int LookAhead(CurPos curPos = CurPos::Begin, int offset = 0);
 
+  // The run of bytes equal to the current one, with the bytes before and
+  // after it as At sees them. Padded reads ahead without end of data checks,
+  // the data then has to be a view into a PaddedString.
+  template <bool Padded>
+  int CurrentRun(char& prev, char& next);
+
  protected:
   std::string_view data_;
   std::string_view::iterator begin_, it_;
   bool updateBegin_ = false;
   bool followedByWhiteSpace_ = false;
+  Diagnostics* diagnostics_ = nullptr;
 
   std::string_view::iterator GetIterator(CurPos curPos);
   bool ValidArgs(int offset, std::string_view::iterator);
 };
 
+template <bool Padded>
+int Scanner::CurrentRun(char& prev, char& next) {
+  if constexpr (!Padded) {
+    int count = LookAhead(CurPos::Cur, -1);
+    prev = At(CurPos::Cur, -2);
+    next = At(CurPos::Cur, count - 1);
+    return count;
+  } else {
+    const char* begin = data_.data();
+    const char* end = begin + data_.size();
+    const char* run = begin + std::distance(data_.begin(), it_) - 1;
+    // stops at the padding at the latest, delimiters are never zero
+    size_t count = 1;
+    while (run[count] == *run) {
+      count++;
+    }
+    count = std::min<size_t>(count, end - run);
+
+    // At sees the first byte and the end of the data as whitespace
+    prev = run - begin > 1 ? run[-1] : run == begin ? '\0' : ' ';
+    next = run + count == end ? ' ' : run[count];
+    followedByWhiteSpace_ = next == ' ' && run + count != end;
+    return static_cast<int>(count);
+  }
+}
+
 }  // namespace markdown
 
 #endif  // !PARSEMD_SCANNER_H_
@@ -0,0 +1,746 @@
+#ifndef PARSEMD_STATIC_H_
+#define PARSEMD_STATIC_H_
+
+// Markdown in string literals, parsed at compile time:
+//
+//   static constexpr auto usage = PARSEMD_STATIC_HTML(
+//       "# Usage\n"
+//       "Run it with **care**\n");
+//   std::fputs(usage.c_str(), stdout);
+//
+// The literal parser is a constexpr copy of BasicParser's block and inline
+// passes. Fixed arrays sized from the literal stand in for the token list and
+// the DelimiterStack, and the nodes are handed to a sink in document order
+// instead of being allocated, so it builds the same tree and HTML as a parse
+// at runtime. Every step counts against the compiler's constexpr limits
+// (-fconstexpr-ops-limit), it is meant for literals of a few KB.
+
+#include "flattree.h"
+#include "html.h"
+#include "internal.h"
+#include "limits.h"
+#include "types.h"
+
+namespace markdown {
+
+// A parsed literal in the layout of FlatTree, Size nodes in document order.
+// Text offsets are into the literal, see Source.
+template <size_t Size>
+class StaticTree {
+ public:
+  static constexpr uint32_t npos = UINT32_MAX;
+
+  FlatNode nodes[Size] = {};
+  std::string_view source;
+
+  static constexpr size_t size() { return Size; }
+  constexpr const FlatNode& operator[](uint32_t index) const {
+    return nodes[index];
+  }
+
+  constexpr TokenType Type(uint32_t index) const {
+    return static_cast<TokenType>(nodes[index].type);
+  }
+  constexpr Alignment Align(uint32_t index) const {
+    return static_cast<Alignment>(nodes[index].align);
+  }
+  constexpr std::string_view Text(uint32_t index) const {
+    return source.substr(nodes[index].text, nodes[index].textSize);
+  }
+  constexpr std::string_view Source() const { return source; }
+  // npos when there is none
+  constexpr uint32_t FirstChild(uint32_t index) const {
+    return index + 1 < nodes[index].end ? index + 1 : npos;
+  }
+  constexpr uint32_t NextSibling(uint32_t index) const {
+    uint32_t next = nodes[index].end;
+    if (next < Size && nodes[next].depth == nodes[index].depth) {
+      return next;
+    }
+    return npos;
+  }
+};
+
+// Size characters and a terminating '\0'
+template <size_t Size>
+struct StaticString {
+  char data[Size + 1] = {};
+
+  static constexpr size_t size() { return Size; }
+  constexpr const char* c_str() const { return data; }
+  constexpr std::string_view View() const { return {data, Size}; }
+  constexpr operator std::string_view() const { return View(); }
+};
+
+namespace internal {
+
+// BasicParser<Ext> over documents of up to Capacity bytes, without allocating.
+// Parse hands the tree to a sink as
+//   Open(TokenType, Alignment), Close(TokenType), Text(std::string_view)
+// in document order. Each block is parsed inline right after it is found, so
+// the block scanner and the inline scanner keep their own positions.
+template <Extension Ext, size_t Capacity>
+class StaticParser {
+ public:
+  template <typename Sink>
+  constexpr void Parse(std::string_view doc, Sink& sink) {
+    doc_ = doc;
+    lineBegin_ = lineIt_ = 0;
+    sink.Open(TokenType::Root, Alignment::None);
+    while (!LinesEnd()) {
+      BuildBlock(sink);
+    }
+    sink.Close(TokenType::Root);
+  }
+
+ protected:
+  static constexpr uint32_t npos = UINT32_MAX;
+  // openersBottom before it is first set, never a delimiter
+  static constexpr uint32_t noBottom = npos - 1;
+
+  enum class DelimiterType : unsigned char { Open, Close, Both };
+
+  // Entries of the token and delimiter lists are linked by index and never
+  // reused, a block scans at most one token per byte and emphasis inserts at
+  // most one per matched byte.
+  struct Token {
+    TokenType type = TokenType::None;
+    std::string_view text;
+    uint32_t prev = npos;
+    uint32_t next = npos;
+  };
+  struct Delimiter {
+    unsigned char kind = 0;
+    DelimiterType type = DelimiterType::Open;
+    size_t number = 0;
+    uint32_t token = npos;
+    uint32_t prev = npos;
+    uint32_t next = npos;
+  };
+
+  std::string_view doc_;
+  // block scanner, a line is [lineBegin_, lineIt_)
+  size_t lineBegin_ = 0;
+  size_t lineIt_ = 0;
+  // cells of the current table row and the columns of the table
+  std::string_view cells_[Capacity + 1] = {};
+  size_t cellCount_ = 0;
+  Alignment aligns_[Capacity + 1] = {};
+  size_t alignCount_ = 0;
+
+  // inline scanner over text_
+  std::string_view text_;
+  size_t begin_ = 0;
+  size_t it_ = 0;
+  Token tokens_[2 * Capacity + 2] = {};
+  uint32_t tokenCount_ = 0;
+  uint32_t head_ = npos;
+  uint32_t tail_ = npos;
+  // delimiters_[0] is the bottom of the stack
+  Delimiter delimiters_[Capacity + 2] = {};
+  uint32_t delimiterCount_ = 0;
+
+  // Scanner::ScanNextLine and friends
+  constexpr bool LinesEnd() const { return lineIt_ == doc_.size(); }
+  constexpr std::string_view ScanNextLine() {
+    lineBegin_ = lineIt_;
+    while (lineIt_ != doc_.size() && doc_[lineIt_] != '\n') {
+      lineIt_++;
+    }
+    std::string_view line = doc_.substr(lineBegin_, lineIt_ - lineBegin_);
+    if (lineIt_ != doc_.size()) {
+      lineIt_++;
+    }
+    return line;
+  }
+  constexpr std::string_view CurrentLine() const {
+    return doc_.substr(lineBegin_, lineIt_ - lineBegin_);
+  }
+  constexpr std::string_view PeekNextLine() const {
+    size_t end = lineIt_;
+    while (end != doc_.size() && doc_[end] != '\n') {
+      end++;
+    }
+    return doc_.substr(lineIt_, end - lineIt_);
+  }
+  constexpr void UnscanLine() { lineIt_ = lineBegin_; }
+
+  template <typename Sink>
+  constexpr void BuildBlock(Sink& sink) {
+    std::string_view line;
+    while (!(line = ScanNextLine()).empty() || !LinesEnd()) {
+      size_t pos = line.find_first_not_of(' ');
+      if (pos == std::string_view::npos) {
+        continue;
+      }
+      size_t count = 0;
+      TokenType heading = HeadingType(line, pos, count);
+      if (heading != TokenType::Text) {
+        sink.Open(heading, Alignment::None);
+        BuildInline(HeadingText(line, pos + count + 1), sink);
+        sink.Close(heading);
+        return;
+      }
+      if constexpr (HasExtension(Ext, Extension::Tables)) {
+        if (IsTableStart(line)) {
+          BuildTable(sink);
+          return;
+        }
+      }
+      BuildParagraph(sink);
+      return;
+    }
+  }
+
+  static constexpr TokenType HeadingType(std::string_view line, size_t pos,
+                                         size_t& count) {
+    if (line[pos] != '#') {
+      return TokenType::Text;
+    }
+    count = 1;
+    while (pos + count != line.size() && line[pos + count] == '#') {
+      count++;
+    }
+    if (pos + count == line.size() || line[pos + count] != ' ' || count > 6) {
+      return TokenType::Text;
+    }
+    return TokenType::H1 + static_cast<int>(count - 1);
+  }
+
+  // markdown::trim of the text after the marker, spaces only
+  static constexpr std::string_view HeadingText(std::string_view line,
+                                                size_t begin) {
+    line.remove_prefix(begin);
+    size_t first = line.find_first_not_of(' ');
+    if (first == std::string_view::npos) {
+      return line.substr(line.size());
+    }
+    return line.substr(first, line.find_last_not_of(' ') + 1 - first);
+  }
+
+  template <typename Sink>
+  constexpr void BuildParagraph(Sink& sink) {
+    std::string_view line = CurrentLine();
+    const char* begin = line.data();
+    const char* end = line.data() + line.size();
+    while (!line.empty() || !LinesEnd()) {
+      size_t pos = line.find_first_not_of(' ');
+      if (line.empty() || pos == std::string_view::npos) {
+        break;
+      }
+      if constexpr (HasExtension(Ext, Extension::Tables)) {
+        if (line.data() != begin && IsTableStart(line)) {
+          UnscanLine();
+          break;
+        }
+      }
+      end = line.data() + line.size();
+      line = ScanNextLine();
+    }
+
+    std::string_view text(begin, end - begin);
+    htrim(text);
+    sink.Open(TokenType::Paragraph, Alignment::None);
+    BuildInline(text, sink);
+    sink.Close(TokenType::Paragraph);
+  }
+
+  // internal::SplitTableRow into cells_
+  constexpr void SplitTableRow(std::string_view row) {
+    cellCount_ = 0;
+    htrim(row);
+    if (!row.empty() && row.front() == '|') {
+      row.remove_prefix(1);
+    }
+
+    size_t begin = 0;
+    for (size_t pos = 0; pos < row.size(); pos++) {
+      if (row[pos] == '|' && !IsEscaped(row, pos)) {
+        std::string_view cell = row.substr(begin, pos - begin);
+        htrim(cell);
+        cells_[cellCount_++] = cell;
+        begin = pos + 1;
+      }
+    }
+    if (begin < row.size() || cellCount_ == 0) {
+      std::string_view cell = row.substr(begin);
+      htrim(cell);
+      cells_[cellCount_++] = cell;
+    }
+  }
+
+  constexpr bool IsTableStart(std::string_view line) {
+    if (line.find('|') == std::string_view::npos) {
+      return false;
+    }
+    std::string_view delimiterRow = PeekNextLine();
+    if (delimiterRow.find('|') == std::string_view::npos) {
+      return false;
+    }
+    SplitTableRow(delimiterRow);
+    alignCount_ = 0;
+    for (size_t i = 0; i < cellCount_; i++) {
+      if (!ParseTableDelimiterCell(cells_[i], aligns_[alignCount_++])) {
+        return false;
+      }
+    }
+
+    SplitTableRow(line);
+    return cellCount_ == alignCount_;
+  }
+
+  template <typename Sink>
+  constexpr void BuildTable(Sink& sink) {
+    sink.Open(TokenType::Table, Alignment::None);
+    BuildTableRow(TokenType::TableHead, sink);
+    ScanNextLine();  // delimiter row
+
+    std::string_view line;
+    while (!(line = ScanNextLine()).empty() || !LinesEnd()) {
+      size_t pos = line.find_first_not_of(' ');
+      if (line.empty() || pos == std::string_view::npos) {
+        break;
+      }
+      size_t count = 0;
+      if (HeadingType(line, pos, count) != TokenType::Text) {
+        UnscanLine();
+        break;
+      }
+      SplitTableRow(line);
+      BuildTableRow(TokenType::TableRow, sink);
+    }
+    sink.Close(TokenType::Table);
+  }
+
+  // cells_ padded with empty cells or truncated to the columns
+  template <typename Sink>
+  constexpr void BuildTableRow(TokenType type, Sink& sink) {
+    sink.Open(type, Alignment::None);
+    for (size_t i = 0; i < alignCount_; i++) {
+      sink.Open(TokenType::TableCell, aligns_[i]);
+      if (i < cellCount_) {
+        BuildInline(cells_[i], sink);
+      }
+      sink.Close(TokenType::TableCell);
+    }
+    sink.Close(type);
+  }
+
+  // Token list
+
+  constexpr uint32_t NewToken(TokenType type, std::string_view text) {
+    tokens_[tokenCount_] = {type, text, npos, npos};
+    return tokenCount_++;
+  }
+  constexpr void PushToken(TokenType type, std::string_view text) {
+    uint32_t token = NewToken(type, text);
+    tokens_[token].prev = tail_;
+    (tail_ == npos ? head_ : tokens_[tail_].next) = token;
+    tail_ = token;
+  }
+  constexpr void InsertToken(uint32_t next, TokenType type,
+                             std::string_view text) {
+    uint32_t token = NewToken(type, text);
+    uint32_t prev = tokens_[next].prev;
+    tokens_[token].prev = prev;
+    tokens_[token].next = next;
+    tokens_[next].prev = token;
+    (prev == npos ? head_ : tokens_[prev].next) = token;
+  }
+  constexpr void InsertTokenAfter(uint32_t prev, TokenType type,
+                                  std::string_view text) {
+    if (tokens_[prev].next == npos) {
+      PushToken(type, text);
+    } else {
+      InsertToken(tokens_[prev].next, type, text);
+    }
+  }
+  constexpr void EraseDelimiter(uint32_t index) {
+    Delimiter& d = delimiters_[index];
+    delimiters_[d.prev].next = d.next;
+    if (d.next != npos) {
+      delimiters_[d.next].prev = d.prev;
+    }
+  }
+
+  // Inline scan, BasicParser::ScanInline
+
+  constexpr std::string_view Lexeme() const {
+    return text_.substr(begin_, it_ - begin_);
+  }
+  constexpr void PushCandToken() {
+    std::string_view lexeme = Lexeme();
+    if (!lexeme.empty() && lexeme != "\n") {
+      PushToken(TokenType::Text, lexeme);
+    }
+  }
+  constexpr void FlushBytes(size_t n) {
+    begin_ = it_ = begin_ + n;
+  }
+
+  constexpr void ScanInline(std::string_view text) {
+    text_ = text;
+    begin_ = it_ = 0;
+    tokenCount_ = 0;
+    head_ = tail_ = npos;
+    delimiters_[0] = {};
+    delimiterCount_ = 1;
+
+    while (it_ != text_.size()) {
+      char c = text_[it_++];
+      if (c == '\n') {
+        PushCandToken();
+        begin_ = it_ - 1;
+        PushToken(TokenType::Softbreak, text_.substr(begin_, 1));
+        FlushBytes(1);
+      } else if (delimiterKind<Ext>[static_cast<unsigned char>(c)] >= 0) {
+        // Scanner::CurrentRun, the first byte of the text and its end count
+        // as whitespace
+        size_t run = it_ - 1, count = 1;
+        while (run + count != text_.size() && text_[run + count] == c) {
+          count++;
+        }
+        char prev = run > 1 ? text_[run - 1] : run == 0 ? '\0' : ' ';
+        char next = run + count == text_.size() ? ' ' : text_[run + count];
+        if (IsValidDelimiter(prev, c, next)) {
+          PushDelimiterRun(count, prev, next);
+        } else {
+          it_ += count - 1;
+        }
+      }
+    }
+    PushCandToken();
+  }
+
+  constexpr void PushDelimiterRun(size_t count, char prev, char next) {
+    std::string_view lexeme = Lexeme();
+    if (lexeme.size() > 1) {
+      lexeme.remove_suffix(1);
+      PushToken(TokenType::Text, lexeme);
+    }
+    begin_ = it_ - 1;
+    lexeme = text_.substr(begin_, count);
+
+    int kind = delimiterKind<Ext>[static_cast<unsigned char>(lexeme[0])];
+    const DelimiterRule& rule = delimiterRules[kind];
+    bool left = IsLeftFlanking(prev, next);
+    bool right = IsRightFlanking(prev, next);
+    bool canOpen = left, canClose = right;
+    if (!rule.intraword) {
+      canOpen = left && (!right || IsPunctuation(prev));
+      canClose = right && (!left || IsPunctuation(next));
+    }
+
+    if ((!canOpen && !canClose) || (rule.maxRun && count > rule.maxRun)) {
+      PushToken(TokenType::Text, lexeme);
+      FlushBytes(count);
+      return;
+    }
+
+    PushToken(TokenType::None, lexeme);
+    uint32_t index = delimiterCount_++;
+    delimiters_[index] = {
+        static_cast<unsigned char>(kind),
+        (canOpen && canClose) ? DelimiterType::Both
+        : canOpen             ? DelimiterType::Open
+                              : DelimiterType::Close,
+        count,
+        tail_,
+        index - 1,
+        npos,
+    };
+    delimiters_[index - 1].next = index;
+    FlushBytes(count);
+  }
+
+  // DelimiterStack::IsMatch
+  static constexpr bool IsMatch(const Delimiter& opener,
+                                const Delimiter& closer) {
+    if (opener.kind != closer.kind || opener.type == DelimiterType::Close) {
+      return false;
+    }
+    const DelimiterRule& rule = delimiterRules[closer.kind];
+    if (rule.exactLength) {
+      return opener.number == closer.number;
+    }
+    if (!rule.ruleOfThree) {
+      return true;
+    }
+    if (opener.type != DelimiterType::Both &&
+        closer.type != DelimiterType::Both) {
+      return true;
+    }
+    if (opener.number % 3 == 0 && closer.number % 3 == 0) {
+      return true;
+    }
+    return (opener.number + closer.number) % 3;
+  }
+
+  constexpr void ToText(const Delimiter& d) {
+    Token& token = tokens_[d.token];
+    token.type = TokenType::Text;
+    token.text = token.text.substr(0, d.number);
+  }
+
+  // DelimiterStack::ProcessEmphasis
+  constexpr void ProcessEmphasis() {
+    uint32_t openersBottom[delimiterKinds] = {};
+    for (size_t i = 0; i < delimiterKinds; i++) {
+      openersBottom[i] = noBottom;
+    }
+
+    uint32_t cur = delimiters_[0].next;
+    while (cur != npos) {
+      while (cur != npos && delimiters_[cur].type == DelimiterType::Open) {
+        if (openersBottom[delimiters_[cur].kind] == 0) {
+          openersBottom[delimiters_[cur].kind] = cur;
+        }
+        cur = delimiters_[cur].next;
+      }
+      if (cur == npos) {
+        break;
+      }
+
+      uint32_t opener = delimiters_[cur].prev;
+      while (opener != 0 && opener != openersBottom[delimiters_[cur].kind]) {
+        if (IsMatch(delimiters_[opener], delimiters_[cur])) {
+          break;
+        }
+        opener = delimiters_[opener].prev;
+      }
+
+      // not found
+      if (opener == 0 || !IsMatch(delimiters_[opener], delimiters_[cur])) {
+        openersBottom[delimiters_[cur].kind] = delimiters_[cur].prev;
+        uint32_t next = delimiters_[cur].next;
+        if (delimiters_[cur].type != DelimiterType::Both) {
+          tokens_[delimiters_[cur].token].type = TokenType::Text;
+          EraseDelimiter(cur);
+        }
+        cur = next;
+        continue;
+      }
+
+      while (delimiters_[opener].next != cur) {
+        uint32_t between = delimiters_[opener].next;
+        ToText(delimiters_[between]);
+        EraseDelimiter(between);
+      }
+
+      Delimiter &open = delimiters_[opener], &close = delimiters_[cur];
+      const DelimiterRule& rule = delimiterRules[open.kind];
+      size_t len = rule.exactLength
+                       ? open.number
+                       : 1 + (open.number >= 2 && close.number >= 2);
+      TokenType type = (len >= 2) ? rule.twice : rule.single;
+      open.number -= len;
+      close.number -= len;
+
+      Token& openToken = tokens_[open.token];
+      Token& closeToken = tokens_[close.token];
+      std::string_view openRun = openToken.text, closeRun = closeToken.text;
+      if (open.number == 0) {
+        openToken.type = type + 1;
+        openToken.text = openRun.substr(open.number, len);
+        EraseDelimiter(opener);
+      } else {
+        openToken.text = openRun.substr(0, open.number);
+        InsertTokenAfter(open.token, type + 1,
+                         openRun.substr(open.number, len));
+      }
+      if (close.number == 0) {
+        closeToken.type = type + 2;
+        closeToken.text = closeRun.substr(0, len);
+        uint32_t next = close.next;
+        EraseDelimiter(cur);
+        cur = next;
+      } else {
+        closeToken.text = closeRun.substr(len, close.number);
+        InsertToken(close.token, type + 2, closeRun.substr(0, len));
+      }
+    }
+
+    for (cur = delimiters_[0].next; cur != npos; cur = delimiters_[cur].next) {
+      ToText(delimiters_[cur]);
+    }
+  }
+
+  // BasicParser::BuildInline: adjacent text tokens are one node, containers
+  // are laid out as Type, TypeOpen, TypeClose. Containers nested deeper than
+  // the default ParseLimits::maxDepth are literal text, see FlattenInline.
+  template <typename Sink>
+  constexpr void BuildInline(std::string_view text, Sink& sink) {
+    ScanInline(text);
+    ProcessEmphasis();
+    size_t depth = 0;
+    for (uint32_t it = head_; it != npos;) {
+      TokenType type = tokens_[it].type;
+      if (type == TokenType::Text) {
+        const char* begin = tokens_[it].text.data();
+        size_t size = 0;
+        for (; it != npos && tokens_[it].type == TokenType::Text;
+             it = tokens_[it].next) {
+          size += tokens_[it].text.size();
+        }
+        sink.Text(std::string_view(begin, size));
+        continue;
+      }
+      if (type == TokenType::Softbreak) {
+        sink.Open(type, Alignment::None);
+        sink.Close(type);
+      } else if (IsInlineOpen(type)) {
+        if (depth >= ParseLimits::defaultMaxDepth) {
+          FlattenInline(it);
+          continue;
+        }
+        depth++;
+        sink.Open(type + -1, Alignment::None);
+      } else if (IsInlineOpen(type + -1)) {
+        depth--;
+        sink.Close(type + -2);
+      }
+      it = tokens_[it].next;
+    }
+  }
+
+  // BasicParser::FlattenInline
+  constexpr void FlattenInline(uint32_t it) {
+    size_t open = 0;
+    do {
+      TokenType type = tokens_[it].type;
+      if (IsInlineOpen(type)) {
+        open++;
+      } else if (IsInlineOpen(type + -1)) {
+        open--;
+      }
+      if (type != TokenType::Softbreak) {
+        tokens_[it].type = TokenType::Text;
+      }
+      it = tokens_[it].next;
+    } while (open);
+  }
+};
+
+struct StaticNodeCounter {
+  size_t nodes = 0;
+
+  constexpr void Open(TokenType, Alignment) { nodes++; }
+  constexpr void Close(TokenType) {}
+  constexpr void Text(std::string_view) { nodes++; }
+};
+
+template <size_t Size>
+struct StaticTreeBuilder {
+  StaticTree<Size> tree;
+  uint32_t open[Size] = {};
+  uint32_t size = 0;
+  uint16_t depth = 0;
+
+  constexpr void Open(TokenType type, Alignment align) {
+    open[depth] = size;
+    tree.nodes[size++] = {0,
+                          0,
+                          0,
+                          depth++,
+                          static_cast<uint8_t>(type),
+                          static_cast<uint8_t>(align)};
+  }
+  constexpr void Close(TokenType) { tree.nodes[open[--depth]].end = size; }
+  constexpr void Text(std::string_view text) {
+    tree.nodes[size] = {static_cast<uint32_t>(text.data() -
+                                              tree.source.data()),
+                        static_cast<uint32_t>(text.size()),
+                        size + 1,
+                        depth,
+                        static_cast<uint8_t>(TokenType::Text),
+                        0};
+    size++;
+  }
+};
+
+// Counts the bytes past Size instead of writing them
+template <size_t Size>
+struct StaticHtmlWriter {
+  StaticString<Size> html;
+  size_t size = 0;
+  HtmlMarkup markup;
+
+  constexpr void Append(std::string_view sv) {
+    for (char c : sv) {
+      if (size < Size) {
+        html.data[size] = c;
+      }
+      size++;
+    }
+  }
+  constexpr void Open(TokenType type, Alignment align) {
+    markup.Open(type, align, [this](std::string_view sv) { Append(sv); });
+  }
+  constexpr void Close(TokenType type) {
+    markup.Close(type, [this](std::string_view sv) { Append(sv); });
+  }
+  constexpr void Text(std::string_view text) {
+    for (char c : text) {
+      std::string_view escaped = HtmlEscape(c);
+      Append(escaped.empty() ? std::string_view(&c, 1) : escaped);
+    }
+    markup.Text(text);
+  }
+};
+
+// The literal without its '\0'
+template <size_t N>
+constexpr std::string_view LiteralView(const char (&literal)[N]) {
+  return std::string_view(literal, N - 1);
+}
+
+}  // namespace internal
+
+// Nodes in the tree of a literal, the Size of ParseStatic
+template <Extension Ext = dialect::GFM, size_t N>
+constexpr size_t StaticTreeSize(const char (&literal)[N]) {
+  internal::StaticParser<Ext, N> parser;
+  internal::StaticNodeCounter counter;
+  parser.Parse(internal::LiteralView(literal), counter);
+  return counter.nodes;
+}
+
+// The tree of a literal, which it points into. Size has to be
+// StaticTreeSize(literal), PARSEMD_STATIC_TREE fills it in.
+template <size_t Size, Extension Ext = dialect::GFM, size_t N>
+constexpr StaticTree<Size> ParseStatic(const char (&literal)[N]) {
+  internal::StaticParser<Ext, N> parser;
+  internal::StaticTreeBuilder<Size> builder;
+  builder.tree.source = internal::LiteralView(literal);
+  parser.Parse(builder.tree.source, builder);
+  return builder.tree;
+}
+
+// Length of the HTML of a literal, the Size of ToStaticHtml
+template <Extension Ext = dialect::GFM, size_t N>
+constexpr size_t StaticHtmlSize(const char (&literal)[N]) {
+  internal::StaticParser<Ext, N> parser;
+  internal::StaticHtmlWriter<0> writer;
+  parser.Parse(internal::LiteralView(literal), writer);
+  return writer.size;
+}
+
+// ToHtml of a literal. Size has to be StaticHtmlSize(literal),
+// PARSEMD_STATIC_HTML fills it in.
+template <size_t Size, Extension Ext = dialect::GFM, size_t N>
+constexpr StaticString<Size> ToStaticHtml(const char (&literal)[N]) {
+  internal::StaticParser<Ext, N> parser;
+  internal::StaticHtmlWriter<Size> writer;
+  parser.Parse(internal::LiteralView(literal), writer);
+  return writer.html;
+}
+
+}  // namespace markdown
+
+// GFM; for CommonMark call the functions with dialect::CommonMark
+#define PARSEMD_STATIC_TREE(literal) \
+  ::markdown::ParseStatic<::markdown::StaticTreeSize(literal)>(literal)
+#define PARSEMD_STATIC_HTML(literal) \
+  ::markdown::ToStaticHtml<::markdown::StaticHtmlSize(literal)>(literal)
+
+#endif  // !PARSEMD_STATIC_H_
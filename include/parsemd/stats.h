@@ -0,0 +1,69 @@
+#ifndef PARSEMD_STATS_H_
+#define PARSEMD_STATS_H_
+
+// Parse statistics, only collected when built with PARSEMD_STATS. Without it
+// every PARSEMD_STAT* use expands to nothing and the parser carries no
+// counters at all.
+
+#include <chrono>
+
+#include "types.h"
+
+namespace markdown {
+
+struct ParseStats {
+  enum Stage : unsigned char { Blocks, InlineScan, Emphasis, TreeBuild };
+  static constexpr size_t stageCount = TreeBuild + 1;
+
+  // Complete event of a Chrome trace, times in ns since the steady clock epoch
+  struct TraceEvent {
+    Stage stage;
+    uint64_t begin;
+    uint64_t duration;
+  };
+
+  uint64_t stageNanos[stageCount] = {};
+  uint64_t lines = 0;
+  uint64_t blocks = 0;
+  uint64_t tokens = 0;
+  uint64_t delimiterPushes = 0;
+  uint64_t openerSteps = 0;
+  uint64_t nodes = 0;
+  // Approximate, nodes with their text and token and delimiter list entries
+  uint64_t bytesAllocated = 0;
+
+  // One event per timed stage run while set, see WriteTrace
+  bool trace = false;
+  std::vector<TraceEvent> events;
+
+  void Clear();
+  static std::string_view StageName(Stage stage);
+  // Chrome trace-event JSON (chrome://tracing, Perfetto) of the events
+  void WriteTrace(std::string& out) const;
+};
+
+// Adds the lifetime of the timer to a stage
+class StageTimer {
+ public:
+  StageTimer(ParseStats& stats, ParseStats::Stage stage);
+  ~StageTimer();
+
+ protected:
+  ParseStats& stats_;
+  ParseStats::Stage stage_;
+  std::chrono::steady_clock::time_point begin_;
+};
+
+}  // namespace markdown
+
+#ifdef PARSEMD_STATS
+#define PARSEMD_STAT(expr) (expr)
+#define PARSEMD_STAT_TIMER(stats, stage)       \
+  ::markdown::StageTimer parsemdTimer##stage( \
+      (stats), ::markdown::ParseStats::stage)
+#else
+#define PARSEMD_STAT(expr) ((void)0)
+#define PARSEMD_STAT_TIMER(stats, stage) ((void)0)
+#endif
+
+#endif  // !PARSEMD_STATS_H_
@@ -1,8 +1,10 @@
 #ifndef PARSEMD_PARSE_TYPES_H_
 #define PARSEMD_PARSE_TYPES_H_
 
+#include <cstdint>
 #include <list>
 #include <memory>
+#include <memory_resource>
 #include <ostream>
 #include <string>
 #include <string_view>
@@ -23,20 +25,27 @@ namespace markdown {
   X(H4,               7)  \
   X(H5,               8)  \
   X(H6,               9)  \
+  X(Table,            10) \
+  X(TableHead,        11) \
+  X(TableRow,         12) \
+  X(TableCell,        13) \
                           \
-  X(Softbreak,        10) \
-  X(Whitespace,       11) \
+  X(Softbreak,        14) \
+  X(Whitespace,       15) \
                           \
   /*    Inline Tokens   */\
-  X(Text,             12) \
-  X(Strong,           13) \
-  X(StrongOpen,       14) \
-  X(StrongClose,      15) \
-  X(Emph,             16) \
-  X(EmphOpen,         17) \
-  X(EmphClose,        18) \
-  X(StrongEmph,       19) \
-  X(Code,             20)
+  X(Text,             16) \
+  X(Strong,           17) \
+  X(StrongOpen,       18) \
+  X(StrongClose,      19) \
+  X(Emph,             20) \
+  X(EmphOpen,         21) \
+  X(EmphClose,        22) \
+  X(StrongEmph,       23) \
+  X(Strikethrough,    24) \
+  X(StrikethroughOpen,  25) \
+  X(StrikethroughClose, 26) \
+  X(Code,             27)
 // clang-format on
 
 enum class TokenType {
@@ -44,42 +53,90 @@ enum class TokenType {
   TOKENS
 #undef X
 };
-TokenType operator+(TokenType, int);
+constexpr TokenType operator+(TokenType t, int i) {
+  return static_cast<TokenType>(static_cast<int>(t) + i);
+}
 const std::string TokenStr(const TokenType&);
+std::string_view TokenStrView(const TokenType&);
 std::ostream& operator<<(std::ostream&, const TokenType&);
 
-inline bool IsHeading(TokenType token) {
+constexpr bool IsHeading(TokenType token) {
   return token >= TokenType::H1 && token <= TokenType::H6;
 }
-inline bool IsBlock(TokenType token) {
-  return token >= TokenType::Root && token <= TokenType::H6;
+constexpr bool IsBlock(TokenType token) {
+  return token >= TokenType::Root && token <= TokenType::TableCell;
+}
+constexpr bool IsTable(TokenType token) {
+  return token >= TokenType::Table && token <= TokenType::TableCell;
 }
-inline bool IsInline(TokenType token) {
+constexpr bool IsInline(TokenType token) {
   return token > TokenType::Text && token <= TokenType::Code;
 }
-inline bool IsText(TokenType token) {
+constexpr bool IsInlineOpen(TokenType token) {
+  return token == TokenType::EmphOpen || token == TokenType::StrongOpen ||
+         token == TokenType::StrikethroughOpen;
+}
+constexpr bool IsText(TokenType token) {
   return token == TokenType::Text;
 }
 
+// Extensions on top of CommonMark, selected at compile time through
+// BasicParser<Extension>. Disabled extensions are compiled out of the parse
+// loops instead of being checked at runtime.
+enum class Extension : unsigned {
+  None          = 0,
+  Tables        = 1 << 0,
+  Strikethrough = 1 << 1,
+};
+constexpr Extension operator|(Extension a, Extension b) {
+  return static_cast<Extension>(static_cast<unsigned>(a) |
+                                static_cast<unsigned>(b));
+}
+constexpr bool HasExtension(Extension set, Extension ext) {
+  return (static_cast<unsigned>(set) & static_cast<unsigned>(ext)) != 0;
+}
+
+namespace dialect {
+inline constexpr Extension CommonMark = Extension::None;
+inline constexpr Extension GFM = Extension::Tables | Extension::Strikethrough;
+}  // namespace dialect
+
+// Byte offsets [begin, end) of a node in the parsed document. Only recorded
+// when built with PARSEMD_SOURCE_POS, see NodeBase::Source.
+struct SourceRange {
+  uint32_t begin = 0;
+  uint32_t end = 0;
+};
+
+// Column alignment of a GFM table, taken from its delimiter row
+enum class Alignment : unsigned char { None, Left, Center, Right };
+
 // clang-format off
 struct NodeBase;
 struct ContainerNode;
 struct BlockNode;
 struct InlineNode;
 struct TextNode;
+struct TableCellNode;
 
 class Scanner;
-class Parser;
+template <Extension Ext>
+class BasicParser;
+class LazyDocument;
 
 using Token     = std::pair<TokenType, std::string_view>;
 using Tokens    = std::vector<Token>;
-using TokenList = std::list<Token>;
+using TokenList = std::pmr::list<Token>;
 using Node      = std::shared_ptr<NodeBase>;
-using Nodes     = std::vector<Node>;
+using Nodes     = std::pmr::vector<Node>;
 using Container = std::shared_ptr<ContainerNode>;
 using Block     = std::shared_ptr<BlockNode>;
 using Inline    = std::shared_ptr<InlineNode>;
 using Text      = std::shared_ptr<TextNode>;
+using TableCell = std::shared_ptr<TableCellNode>;
+
+using Parser           = BasicParser<dialect::GFM>;
+using CommonMarkParser = BasicParser<dialect::CommonMark>;
 // clang-format on
 
 }  // namespace markdown
@@ -0,0 +1,174 @@
+#include <cstring>
+
+#include "parsemd/binary.h"
+#include "parsemd/node.h"
+
+namespace markdown {
+
+void SerializeBinary(const Node& root, std::string& out) {
+  out.clear();
+  if (!root) {
+    return;
+  }
+
+  // breadth first order, every node's children are appended in one go
+  std::vector<const NodeBase*> order = {root.get()};
+  std::vector<BinaryNode> nodes;
+  std::string strings;
+  for (size_t i = 0; i < order.size(); i++) {
+    const NodeBase* node = order[i];
+    BinaryNode record = {};
+    record.type = static_cast<uint8_t>(node->Type());
+    record.sourceBegin = node->Source().begin;
+    record.sourceEnd = node->Source().end;
+
+    std::string_view text;
+    if (const TextNode* tnode = TextNodePtr(node)) {
+      text = tnode->text;
+    } else {
+      const ContainerNode* cnode = ContainerNodePtr(node);
+      record.firstChild = order.size();
+      record.childCount = cnode->children.size();
+      for (const Node& child : cnode->children) {
+        order.push_back(child.get());
+      }
+
+      if (const BlockNode* bnode = BlockNodePtr(node)) {
+        text = bnode->RawText();
+      }
+      if (const TableCellNode* cell = TableCellNodePtr(node)) {
+        record.align = static_cast<uint8_t>(cell->align);
+      }
+    }
+
+    record.text = strings.size();
+    record.textSize = text.size();
+    strings.append(text);
+    nodes.push_back(record);
+  }
+
+  BinaryHeader header = {};
+  std::memcpy(header.magic, binaryMagic, sizeof(binaryMagic));
+  header.version = binaryVersion;
+  header.nodeCount = nodes.size();
+  header.stringBytes = strings.size();
+#ifdef PARSEMD_SOURCE_POS
+  header.flags |= binarySourcePos;
+#endif
+
+  out.reserve(sizeof(header) + nodes.size() * sizeof(BinaryNode) +
+              strings.size());
+  out.append(reinterpret_cast<const char*>(&header), sizeof(header));
+  out.append(reinterpret_cast<const char*>(nodes.data()),
+             nodes.size() * sizeof(BinaryNode));
+  out.append(strings);
+}
+
+std::string SerializeBinary(const Node& root) {
+  std::string out;
+  SerializeBinary(root, out);
+  return out;
+}
+
+BinaryTree::BinaryTree() {}
+BinaryTree::BinaryTree(std::string_view bytes) {
+  Init(bytes);
+}
+
+bool BinaryTree::Init(std::string_view bytes) {
+  header_ = nullptr;
+  nodes_ = nullptr;
+  strings_ = nullptr;
+
+  if (bytes.size() < sizeof(BinaryHeader) ||
+      reinterpret_cast<uintptr_t>(bytes.data()) % alignof(BinaryHeader)) {
+    return false;
+  }
+  const BinaryHeader* header =
+      reinterpret_cast<const BinaryHeader*>(bytes.data());
+  if (std::memcmp(header->magic, binaryMagic, sizeof(binaryMagic)) ||
+      header->version != binaryVersion || header->nodeCount == 0) {
+    return false;
+  }
+  uint64_t size = sizeof(BinaryHeader) +
+                  uint64_t(header->nodeCount) * sizeof(BinaryNode) +
+                  header->stringBytes;
+  if (size > bytes.size()) {
+    return false;
+  }
+
+  header_ = header;
+  nodes_ = reinterpret_cast<const BinaryNode*>(bytes.data() +
+                                               sizeof(BinaryHeader));
+  strings_ = reinterpret_cast<const char*>(nodes_ + header->nodeCount);
+  return true;
+}
+
+bool BinaryTree::Valid() const {
+  return header_ != nullptr;
+}
+
+BinaryTree::NodeView BinaryTree::Root() const {
+  return At(0);
+}
+
+BinaryTree::NodeView BinaryTree::At(uint32_t index) const {
+  if (!Valid() || index >= header_->nodeCount) {
+    return {};
+  }
+  return NodeView(this, index);
+}
+
+uint32_t BinaryTree::NodeCount() const {
+  return Valid() ? header_->nodeCount : 0;
+}
+
+bool BinaryTree::HasSourcePos() const {
+  return Valid() && (header_->flags & binarySourcePos);
+}
+
+BinaryTree::NodeView::NodeView() {}
+BinaryTree::NodeView::NodeView(const BinaryTree* tree, uint32_t index)
+    : tree_(tree), node_(tree->nodes_ + index), index_(index) {}
+
+bool BinaryTree::NodeView::Valid() const {
+  return node_ != nullptr;
+}
+
+uint32_t BinaryTree::NodeView::Index() const {
+  return index_;
+}
+
+TokenType BinaryTree::NodeView::Type() const {
+  return node_ ? static_cast<TokenType>(node_->type) : TokenType::None;
+}
+
+Alignment BinaryTree::NodeView::Align() const {
+  return node_ ? static_cast<Alignment>(node_->align) : Alignment::None;
+}
+
+std::string_view BinaryTree::NodeView::Text() const {
+  if (!node_ || uint64_t(node_->text) + node_->textSize >
+                    tree_->header_->stringBytes) {
+    return {};
+  }
+  return std::string_view(tree_->strings_ + node_->text, node_->textSize);
+}
+
+SourceRange BinaryTree::NodeView::Source() const {
+  return node_ ? SourceRange{node_->sourceBegin, node_->sourceEnd}
+               : SourceRange{};
+}
+
+uint32_t BinaryTree::NodeView::ChildCount() const {
+  return node_ ? node_->childCount : 0;
+}
+
+BinaryTree::NodeView BinaryTree::NodeView::Child(uint32_t i) const {
+  if (!node_ || i >= node_->childCount) {
+    return {};
+  }
+  return tree_->At(node_->firstChild + i);
+}
+
+}  // namespace markdown
@@ -0,0 +1,75 @@
+#include "parsemd/blockreader.h"
+
+namespace markdown {
+
+template <Extension Ext>
+BasicBlockReader<Ext>::Iterator::Iterator(BasicBlockReader* reader)
+    : reader_(reader) {
+  ++*this;
+}
+
+template <Extension Ext>
+const Node& BasicBlockReader<Ext>::Iterator::operator*() const {
+  return block_;
+}
+
+template <Extension Ext>
+const Node* BasicBlockReader<Ext>::Iterator::operator->() const {
+  return &block_;
+}
+
+// Becomes the end iterator after the last block
+template <Extension Ext>
+typename BasicBlockReader<Ext>::Iterator&
+BasicBlockReader<Ext>::Iterator::operator++() {
+  block_ = reader_->Next();
+  if (!block_) {
+    reader_ = nullptr;
+  }
+  return *this;
+}
+
+template <Extension Ext>
+bool BasicBlockReader<Ext>::Iterator::operator==(const Iterator& other) const {
+  return reader_ == other.reader_ && block_ == other.block_;
+}
+
+template <Extension Ext>
+bool BasicBlockReader<Ext>::Iterator::operator!=(const Iterator& other) const {
+  return !(*this == other);
+}
+
+template <Extension Ext>
+BasicBlockReader<Ext>::BasicBlockReader(std::string_view source) {
+  parser_.BorrowDocument(source);
+}
+
+template <Extension Ext>
+BasicBlockReader<Ext>::BasicBlockReader(const PaddedString& source) {
+  parser_.BorrowDocument(source);
+}
+
+template <Extension Ext>
+Node BasicBlockReader<Ext>::Next() {
+  return parser_.NextBlock();
+}
+
+template <Extension Ext>
+size_t BasicBlockReader<Ext>::Offset() const {
+  return parser_.BlockOffset();
+}
+
+template <Extension Ext>
+typename BasicBlockReader<Ext>::Iterator BasicBlockReader<Ext>::begin() {
+  return Iterator(this);
+}
+
+template <Extension Ext>
+typename BasicBlockReader<Ext>::Iterator BasicBlockReader<Ext>::end() {
+  return Iterator();
+}
+
+template class BasicBlockReader<dialect::CommonMark>;
+template class BasicBlockReader<dialect::GFM>;
+
+}  // namespace markdown
@@ -0,0 +1,112 @@
+#include "parsemd/cache.h"
+#include "parsemd/internal.h"
+
+namespace markdown {
+
+static SharedDocument ParseShared(std::string_view source) {
+  return std::make_shared<const Document>(Parse(source));
+}
+
+ParseCache::ParseCache(size_t byteBudget, size_t shards)
+    : shards_(std::make_unique<Shard[]>(shards ? shards : 1)),
+      shardCount_(shards ? shards : 1),
+      shardBudget_(byteBudget / shardCount_) {}
+
+ParseCache::Shard& ParseCache::ShardFor(uint64_t hash) {
+  // low bits pick the bucket inside the shard's map, use the high ones here
+  return shards_[(hash >> 32) % shardCount_];
+}
+
+// Expects shard.mutex to be held
+SharedDocument ParseCache::Lookup(Shard& shard,
+                                  uint64_t hash,
+                                  std::string_view source) {
+  auto it = shard.index.find(hash);
+  // a hash collision is treated as a miss
+  if (it == shard.index.end() || it->second->doc->Source() != source) {
+    return nullptr;
+  }
+  shard.lru.splice(shard.lru.begin(), shard.lru, it->second);
+  return it->second->doc;
+}
+
+// Expects shard.mutex to be held
+void ParseCache::Evict(Shard& shard) {
+  // keep at least the newest entry, even if it alone is over budget
+  while (shard.bytes > shardBudget_ && shard.lru.size() > 1) {
+    Entry& entry = shard.lru.back();
+    shard.bytes -= entry.doc->Bytes();
+    shard.index.erase(entry.hash);
+    shard.lru.pop_back();
+    shard.stats.evictions++;
+  }
+}
+
+SharedDocument ParseCache::Get(std::string_view source) {
+  uint64_t hash = internal::Hash64(source);
+  Shard& shard = ShardFor(hash);
+  {
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    if (SharedDocument doc = Lookup(shard, hash, source)) {
+      shard.stats.hits++;
+      return doc;
+    }
+    shard.stats.misses++;
+  }
+
+  // parse without holding the lock, concurrent misses on the same input
+  // settle on whichever document is inserted first
+  SharedDocument doc = ParseShared(source);
+
+  std::lock_guard<std::mutex> lock(shard.mutex);
+  auto it = shard.index.find(hash);
+  if (it != shard.index.end()) {
+    if (it->second->doc->Source() == source) {
+      shard.lru.splice(shard.lru.begin(), shard.lru, it->second);
+      return it->second->doc;
+    }
+    // colliding entry, the newer input replaces it
+    shard.bytes -= it->second->doc->Bytes();
+    shard.lru.erase(it->second);
+    shard.index.erase(it);
+  }
+
+  shard.lru.push_front(Entry{hash, doc});
+  shard.index.emplace(hash, shard.lru.begin());
+  shard.bytes += doc->Bytes();
+  Evict(shard);
+  return doc;
+}
+
+SharedDocument ParseCache::Find(std::string_view source) {
+  uint64_t hash = internal::Hash64(source);
+  Shard& shard = ShardFor(hash);
+  std::lock_guard<std::mutex> lock(shard.mutex);
+  SharedDocument doc = Lookup(shard, hash, source);
+  doc ? shard.stats.hits++ : shard.stats.misses++;
+  return doc;
+}
+
+void ParseCache::Clear() {
+  for (size_t i = 0; i < shardCount_; i++) {
+    std::lock_guard<std::mutex> lock(shards_[i].mutex);
+    shards_[i].lru.clear();
+    shards_[i].index.clear();
+    shards_[i].bytes = 0;
+  }
+}
+
+ParseCache::Stats ParseCache::GetStats() const {
+  Stats total = {};
+  for (size_t i = 0; i < shardCount_; i++) {
+    std::lock_guard<std::mutex> lock(shards_[i].mutex);
+    total.hits += shards_[i].stats.hits;
+    total.misses += shards_[i].stats.misses;
+    total.evictions += shards_[i].stats.evictions;
+    total.entries += shards_[i].lru.size();
+    total.bytes += shards_[i].bytes;
+  }
+  return total;
+}
+
+}  // namespace markdown
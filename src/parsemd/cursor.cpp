@@ -0,0 +1,88 @@
+#include "parsemd/cursor.h"
+#include "parsemd/node.h"
+
+namespace markdown {
+
+Cursor::Cursor(size_t maxDepth) : maxDepth_(maxDepth) {}
+Cursor::Cursor(const NodeBase& root, size_t maxDepth) : maxDepth_(maxDepth) {
+  Reset(root);
+}
+Cursor::Cursor(const Node& root, size_t maxDepth) : maxDepth_(maxDepth) {
+  if (root) {
+    Reset(*root);
+  }
+}
+
+void Cursor::Reset(const NodeBase& root) {
+  stack_.clear();
+  root_ = &root;
+  node_ = nullptr;
+  depth_ = 0;
+  event_ = None;
+  truncated_ = false;
+}
+
+bool Cursor::Next() {
+  if (event_ == None) {
+    if (!root_) {
+      return false;
+    }
+    EnterNode(root_, 0);
+    return true;
+  }
+  if (stack_.empty()) {
+    root_ = node_ = nullptr;
+    event_ = None;
+    return false;
+  }
+
+  Frame& top = stack_.back();
+  if (top.next != top.end) {
+    const NodeBase* child = (top.next++)->get();
+    EnterNode(child, stack_.size());
+    return true;
+  }
+  node_ = top.node;
+  depth_ = stack_.size() - 1;
+  event_ = Exit;
+  stack_.pop_back();
+  return true;
+}
+
+void Cursor::EnterNode(const NodeBase* node, size_t depth) {
+  node_ = node;
+  depth_ = depth;
+  event_ = Enter;
+  const ContainerNode* cnode = ContainerNodePtr(node);
+  if (!cnode) {
+    return;
+  }
+  const Node* begin = cnode->children.data();
+  const Node* end = begin + cnode->children.size();
+  if (depth >= maxDepth_ && begin != end) {
+    truncated_ = true;
+    end = begin;
+  }
+  stack_.push_back({cnode, begin, end});
+}
+
+Cursor::Event Cursor::GetEvent() const {
+  return event_;
+}
+const NodeBase& Cursor::Current() const {
+  return *node_;
+}
+size_t Cursor::Depth() const {
+  return depth_;
+}
+bool Cursor::Truncated() const {
+  return truncated_;
+}
+
+void Cursor::SkipChildren() {
+  if (event_ == Enter && !stack_.empty() && stack_.back().node == node_) {
+    stack_.back().next = stack_.back().end;
+  }
+}
+
+}  // namespace markdown
@@ -1,16 +1,19 @@
+#include <algorithm>
 #include <iostream>
 #include <iterator>
 #include "parsemd/types.h"
 
 #include "parsemd/delimiterstack.h"
+#include "parsemd/stats.h"
 
 namespace markdown {
 
-DelimiterStack::DelimiterStack() {
-  stack_ = {DelimiterStackItem{}};
+DelimiterStack::DelimiterStack(std::pmr::memory_resource* resource)
+    : stack_(resource) {
+  stack_.push_back({});
   dummy_ = cur_ = stack_.begin();
   stackBottom_ = dummy_;
-  openersBottom_[0] = openersBottom_[1] = dummy_;
+  std::fill(std::begin(openersBottom_), std::end(openersBottom_), dummy_);
 }
 
 void DelimiterStack::Push(DelimiterStackItem dsi) {
@@ -22,7 +25,16 @@ void DelimiterStack::Clear() {
   stack_ = {DelimiterStackItem{}};
   dummy_ = cur_ = stack_.begin();
   stackBottom_ = dummy_;
-  openersBottom_[0] = openersBottom_[1] = dummy_;
+  std::fill(std::begin(openersBottom_), std::end(openersBottom_), dummy_);
+  PARSEMD_STAT(openerSteps_ = 0);
+}
+
+uint64_t DelimiterStack::OpenerSteps() const {
+#ifdef PARSEMD_STATS
+  return openerSteps_;
+#else
+  return 0;
+#endif
 }
 
 // https://spec.commonmark.org/0.31.2/#phase-2-inline-structure
@@ -30,13 +42,14 @@ void DelimiterStack::Clear() {
 bool DelimiterStack::ProcessEmphasis(TokenList& candTokens) {
   // NOTE: No Links or Image support yet
   stackBottom_ = stack_.begin();
-  openersBottom_[0] = openersBottom_[1] = {};
+  std::fill(std::begin(openersBottom_), std::end(openersBottom_),
+            DelimStack::iterator());
   cur_ = std::next(stackBottom_);
 
   while (cur_ != stack_.end()) {
     while (cur_ != stack_.end() && cur_->type == DelimiterType::Open) {
-      if (openersBottom_[static_cast<int>(cur_->delim)] == dummy_) {
-        openersBottom_[static_cast<int>(cur_->delim)] = cur_;
+      if (openersBottom_[cur_->kind] == dummy_) {
+        openersBottom_[cur_->kind] = cur_;
       }
       cur_ = std::next(cur_);
     }
@@ -46,25 +59,16 @@ bool DelimiterStack::ProcessEmphasis(TokenList& candTokens) {
     }
 
     DelimStack::iterator opener = std::prev(cur_);
-    while (opener != stackBottom_ &&
-           opener != openersBottom_[static_cast<int>(cur_->delim)]) {
-      if (opener->delim == cur_->delim) {
-        if (opener->type != DelimiterType::Both &&
-            cur_->type != DelimiterType::Both) {
-          break;
-        }
-        if (opener->number % 3 == 0 && cur_->number % 3 == 0) {
-          break;
-        }
-        if ((opener->number + cur_->number) % 3) {
-          break;
-        }
+    while (opener != stackBottom_ && opener != openersBottom_[cur_->kind]) {
+      PARSEMD_STAT(openerSteps_++);
+      if (IsMatch(*opener, *cur_)) {
+        break;
       }
       opener = std::prev(opener);
     }
 
     // found
-    if (opener != stackBottom_ && opener->delim == cur_->delim) {
+    if (opener != stackBottom_ && IsMatch(*opener, *cur_)) {
       DelimStack::iterator temp;
       while ((temp = std::next(opener)) != cur_) {
         temp->tokenIt->first = TokenType::Text;
@@ -74,35 +78,45 @@ bool DelimiterStack::ProcessEmphasis(TokenList& candTokens) {
       }
 
       DelimiterStackItem &open = *opener, &close = *cur_;
-      TokenType type = (open.number >= 2 && close.number >= 2)
-                           ? TokenType::Strong
-                           : TokenType::Emph;
-      int len = 1 + (type == TokenType::Strong);
+      const internal::DelimiterRule& rule = internal::delimiterRules[open.kind];
+      int len = rule.exactLength
+                    ? open.number
+                    : 1 + (open.number >= 2 && close.number >= 2);
+      TokenType type = (len >= 2) ? rule.twice : rule.single;
       open.number -= len;
       close.number -= len;
-      std::string_view sv(open.tokenIt->second.begin(), len);
+
+      // openers are consumed from the end of their run, closers from the
+      // start, so that every token keeps pointing at its own bytes
+      std::string_view openRun = open.tokenIt->second;
+      std::string_view closeRun = close.tokenIt->second;
+      std::string_view openSv(openRun.begin() + open.number, len);
+      std::string_view closeSv(closeRun.begin(), len);
 
       if (open.number == 0) {
         open.tokenIt->first = type + 1;
-        open.tokenIt->second = sv;
+        open.tokenIt->second = openSv;
         stack_.erase(opener);
       } else {
-        candTokens.insert(std::next(open.tokenIt), Token(type + 1, sv));
+        open.tokenIt->second = std::string_view(openRun.begin(), open.number);
+        candTokens.insert(std::next(open.tokenIt), Token(type + 1, openSv));
       }
 
       if (close.number == 0) {
         close.tokenIt->first = type + 2;
-        close.tokenIt->second = sv;
+        close.tokenIt->second = closeSv;
         cur_ = std::next(cur_);
         stack_.erase(temp);
       } else {
-        candTokens.insert(close.tokenIt, Token(type + 2, sv));
+        close.tokenIt->second =
+            std::string_view(closeRun.begin() + len, close.number);
+        candTokens.insert(close.tokenIt, Token(type + 2, closeSv));
       }
     }
 
     // not found
     else {
-      openersBottom_[static_cast<int>(cur_->delim)] = std::prev(cur_);
+      openersBottom_[cur_->kind] = std::prev(cur_);
       if (cur_->type != DelimiterType::Both) {
         DelimStack::iterator temp = cur_;
         cur_->tokenIt->first = TokenType::Text;
@@ -127,19 +141,36 @@ bool DelimiterStack::ProcessEmphasis(TokenList& candTokens) {
   return true;
 }
 
+// https://spec.commonmark.org/0.31.2/#process-emphasis
+bool DelimiterStack::IsMatch(const DelimiterStackItem& opener,
+                             const DelimiterStackItem& closer) {
+  if (opener.kind != closer.kind || opener.type == DelimiterType::Close) {
+    return false;
+  }
+
+  const internal::DelimiterRule& rule = internal::delimiterRules[closer.kind];
+  if (rule.exactLength) {
+    return opener.number == closer.number;
+  }
+  if (!rule.ruleOfThree) {
+    return true;
+  }
+  if (opener.type != DelimiterType::Both &&
+      closer.type != DelimiterType::Both) {
+    return true;
+  }
+  if (opener.number % 3 == 0 && closer.number % 3 == 0) {
+    return true;
+  }
+  return (opener.number + closer.number) % 3;
+}
+
 void DelimiterStack::debug() {
   cur_ = stack_.begin();
   while (cur_ != stack_.end()) {
     auto token = *cur_;
 
-    switch (token.delim) {
-      case Delimiter::Asteriks:
-        std::cout << "Asterisks\t";
-        break;
-      case Delimiter::Underscore:
-        std::cout << "Underscore\t";
-        break;
-    }
+    std::cout << internal::delimiterRules[token.kind].delim << "\t";
     std::cout << token.number << "\t";
     switch (token.type) {
       case DelimiterType::Open:
@@ -0,0 +1,80 @@
+#include <functional>
+
+#include "parsemd/diagnostics.h"
+
+namespace markdown {
+
+std::string_view DiagnosticMessage(DiagnosticCode code) {
+  switch (code) {
+    case DiagnosticCode::EmptyDelimiterRun:
+      return "empty delimiter run";
+    case DiagnosticCode::ScannerOverflow:
+      return "scanner flushed past the end of the input";
+    case DiagnosticCode::UnhandledLine:
+      return "line not part of any block";
+  }
+  return "";
+}
+
+Diagnostics::Diagnostics(size_t capacity, std::pmr::memory_resource* resource)
+    : records_(resource), capacity_(capacity) {
+  records_.reserve(capacity_);
+}
+
+void Diagnostics::Begin(std::string_view document) {
+  document_ = document;
+  Clear();
+}
+
+void Diagnostics::Report(DiagnosticCode code, const char* at) {
+  uint32_t offset = Diagnostic::noOffset;
+  // at may point outside the document, the built-in operators do not order
+  // unrelated pointers
+  const char* begin = document_.data();
+  const char* end = begin + document_.size();
+  if (std::greater_equal<>()(at, begin) && std::less_equal<>()(at, end)) {
+    offset = static_cast<uint32_t>(at - document_.data());
+  }
+
+  Diagnostic diagnostic = {code, offset};
+  if (records_.size() < capacity_) {
+    records_.push_back(diagnostic);
+  } else {
+    dropped_++;
+  }
+  if (handler_) {
+    handler_(diagnostic);
+  }
+}
+
+void Diagnostics::Clear() {
+  records_.clear();
+  dropped_ = 0;
+}
+
+void Diagnostics::SetHandler(DiagnosticHandler handler) {
+  handler_ = std::move(handler);
+}
+
+void Diagnostics::SetCapacity(size_t capacity) {
+  capacity_ = capacity;
+  if (records_.size() > capacity_) {
+    dropped_ += records_.size() - capacity_;
+    records_.resize(capacity_);
+  }
+  records_.reserve(capacity_);
+}
+
+const std::pmr::vector<Diagnostic>& Diagnostics::Records() const {
+  return records_;
+}
+
+size_t Diagnostics::Dropped() const {
+  return dropped_;
+}
+
+bool Diagnostics::Empty() const {
+  return records_.empty() && dropped_ == 0;
+}
+
+}  // namespace markdown
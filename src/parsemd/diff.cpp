@@ -0,0 +1,166 @@
+#include <algorithm>
+
+#include "parsemd/diff.h"
+#include "parsemd/cursor.h"
+#include "parsemd/internal.h"
+#include "parsemd/node.h"
+
+namespace markdown {
+
+uint64_t StructuralHash(const NodeBase& node) {
+#ifdef PARSEMD_NODE_HASH
+  return node.Hash();
+#else
+  if (!ContainerNodePtr(&node)) {
+    return internal::NodeSeedHash(node);
+  }
+
+  // hashes of the open containers, their children combined in so far
+  std::vector<uint64_t> open;
+  uint64_t hash = 0;
+  for (Cursor cursor(node, SIZE_MAX); cursor.Next();) {
+    const NodeBase& current = cursor.Current();
+    uint64_t done;
+    if (cursor.GetEvent() == Cursor::Exit) {
+      done = open.back();
+      open.pop_back();
+    } else if (ContainerNodePtr(&current)) {
+      open.push_back(internal::NodeSeedHash(current));
+      continue;
+    } else {
+      done = internal::NodeSeedHash(current);
+    }
+
+    if (open.empty()) {
+      hash = done;
+    } else {
+      open.back() = internal::HashCombine(open.back(), done);
+    }
+  }
+  return hash;
+#endif
+}
+
+namespace {
+
+using Index = std::ptrdiff_t;
+
+struct Edit {
+  Index x, y;    // before the edit
+  bool remove;   // a[x] removed, else b[y] inserted
+};
+
+// Myers' greedy diff of a and b, the edits in reverse order. False if it
+// takes more than maxEdits.
+bool Myers(const std::vector<uint64_t>& a,
+           const std::vector<uint64_t>& b,
+           size_t maxEdits,
+           std::vector<Edit>& edits) {
+  Index n = a.size(), m = b.size();
+  Index maxD = std::min<Index>(n + m, maxEdits);
+  // furthest x on every diagonal k = x - y, at v[k + offset]
+  Index offset = maxD + 1;
+  std::vector<Index> v(2 * offset + 1, 0);
+  // v after every d, the diagonals -d..d only
+  std::vector<std::vector<Index>> trace;
+
+  Index d = 0;
+  for (bool done = false; !done; d++) {
+    if (d > maxD) {
+      return false;
+    }
+    for (Index k = -d; k <= d; k += 2) {
+      bool down =
+          k == -d || (k != d && v[k - 1 + offset] < v[k + 1 + offset]);
+      Index x = down ? v[k + 1 + offset] : v[k - 1 + offset] + 1;
+      Index y = x - k;
+      while (x < n && y < m && a[x] == b[y]) {
+        x++;
+        y++;
+      }
+      v[k + offset] = x;
+      if (x >= n && y >= m) {
+        done = true;
+        break;
+      }
+    }
+    trace.emplace_back(v.begin() + offset - d, v.begin() + offset + d + 1);
+  }
+
+  // back from (n, m), one edit per step
+  Index x = n, y = m;
+  for (d = trace.size() - 1; d > 0; d--) {
+    const std::vector<Index>& prev = trace[d - 1];
+    auto at = [&](Index k) { return prev[k + d - 1]; };
+    Index k = x - y;
+    bool down = k == -d || (k != d && at(k - 1) < at(k + 1));
+    Index prevK = down ? k + 1 : k - 1;
+    Index prevX = at(prevK);
+    Index prevY = prevX - prevK;
+    edits.push_back({prevX, prevY, !down});
+    x = prevX;
+    y = prevY;
+  }
+  return true;
+}
+
+}  // namespace
+
+std::vector<BlockChange> DiffBlocks(const NodeBase& oldRoot,
+                                    const NodeBase& newRoot,
+                                    size_t maxEdits) {
+  std::vector<BlockChange> changes;
+#ifdef PARSEMD_NODE_HASH
+  if (oldRoot.Hash() == newRoot.Hash()) {
+    return changes;
+  }
+#endif
+  const Nodes& before = ContainerNodePtr(&oldRoot)->children;
+  const Nodes& after = ContainerNodePtr(&newRoot)->children;
+
+  size_t head = 0;
+  while (head < before.size() && head < after.size() &&
+         StructuralHash(*before[head]) == StructuralHash(*after[head])) {
+    head++;
+  }
+  size_t tail = 0;
+  while (tail < before.size() - head && tail < after.size() - head &&
+         StructuralHash(*before[before.size() - 1 - tail]) ==
+             StructuralHash(*after[after.size() - 1 - tail])) {
+    tail++;
+  }
+  size_t oldEnd = before.size() - tail, newEnd = after.size() - tail;
+  if (head == oldEnd && head == newEnd) {
+    return changes;
+  }
+
+  std::vector<uint64_t> a, b;
+  a.reserve(oldEnd - head);
+  b.reserve(newEnd - head);
+  for (size_t i = head; i < oldEnd; i++) {
+    a.push_back(StructuralHash(*before[i]));
+  }
+  for (size_t i = head; i < newEnd; i++) {
+    b.push_back(StructuralHash(*after[i]));
+  }
+
+  std::vector<Edit> edits;
+  if (!Myers(a, b, maxEdits, edits)) {
+    changes.push_back({head, oldEnd, head, newEnd});
+    return changes;
+  }
+
+  // adjacent edits make one change
+  for (auto it = edits.rbegin(); it != edits.rend(); ++it) {
+    size_t x = head + it->x, y = head + it->y;
+    if (changes.empty() || changes.back().oldEnd != x ||
+        changes.back().newEnd != y) {
+      changes.push_back({x, x, y, y});
+    }
+    BlockChange& change = changes.back();
+    (it->remove ? change.oldEnd : change.newEnd)++;
+  }
+  return changes;
+}
+
+}  // namespace markdown
@@ -0,0 +1,236 @@
+#include <cerrno>
+#include <system_error>
+
+#include "parsemd/document.h"
+#include "parsemd/internal.h"
+#include "parsemd/mappedfile.h"
+#include "parsemd/node.h"
+#include "parsemd/parser.h"
+
+namespace markdown {
+
+// Footprint of a node including its shared_ptr control block
+static size_t NodeBytes(const NodeBase* node) {
+  constexpr size_t control = 2 * sizeof(long) + sizeof(void*);
+  if (const TextNode* text = TextNodePtr(node)) {
+    return control + sizeof(TextNode) + text->text.capacity();
+  }
+  size_t size = TableCellNodePtr(node) ? sizeof(TableCellNode)
+                : BlockNodePtr(node)   ? sizeof(BlockNode)
+                                       : sizeof(InlineNode);
+  return control + size +
+         ContainerNodePtr(node)->children.capacity() * sizeof(Node);
+}
+
+Document::Document() : Document(std::make_shared<BlockNode>(TokenType::Root),
+                                 std::string()) {}
+
+Document::Document(Node root, std::string source) : root_(std::move(root)) {
+  auto owner = std::make_shared<const std::string>(std::move(source));
+  source_ = *owner;
+  owner_ = std::move(owner);
+  bytes_ = sizeof(Document) + sizeof(std::string) + source_.size();
+  AddNodeBytes();
+}
+
+Document::Document(Node root,
+                   std::string_view source,
+                   std::shared_ptr<const void> owner,
+                   size_t ownerBytes)
+    : root_(std::move(root)), source_(source), owner_(std::move(owner)) {
+  bytes_ = sizeof(Document) + ownerBytes;
+  AddNodeBytes();
+}
+
+void Document::AddNodeBytes() {
+  std::vector<const NodeBase*> stack = {root_.get()};
+  while (!stack.empty()) {
+    const NodeBase* node = stack.back();
+    stack.pop_back();
+    bytes_ += NodeBytes(node);
+    if (const ContainerNode* cnode = ContainerNodePtr(node)) {
+      for (const Node& child : cnode->children)
+        stack.push_back(child.get());
+    }
+  }
+}
+
+const NodeBase& Document::Root() const {
+  return *root_;
+}
+
+std::string_view Document::Source() const {
+  return source_;
+}
+
+size_t Document::Bytes() const {
+  return bytes_;
+}
+
+// Parses source, a string_view or PaddedString that has to outlive the call,
+// with this thread's scratch parser. A nested call on the same thread gets a
+// parser of its own. Without inlines only the block structure is built.
+template <Extension Ext, typename Source>
+static Node ParseScratch(const Source& source, bool inlines = true) {
+  struct Scratch {
+    BasicParser<Ext> parser;
+    bool busy = false;
+  };
+  thread_local Scratch scratch;
+
+  auto run = [&](BasicParser<Ext>& parser) {
+    parser.BorrowDocument(source);
+    if (!inlines) {
+      parser.AnalyzeBlocks();
+      return parser.GetRoot();
+    }
+    return parser.Parse();
+  };
+
+  if (scratch.busy) {
+    BasicParser<Ext> parser;
+    return run(parser);
+  }
+
+  // frees the scratch parser again, also when run throws
+  struct Release {
+    Scratch& scratch;
+    ~Release() {
+      scratch.parser.Reset();
+      scratch.busy = false;
+    }
+  };
+  scratch.busy = true;
+  Release release{scratch};
+  return run(scratch.parser);
+}
+
+template <Extension Ext>
+Document Parse(std::string_view source) {
+  auto owner = std::make_shared<const PaddedString>(source);
+  Node root = ParseScratch<Ext>(*owner);
+  std::string_view view = *owner;
+  // the buffer has a zero byte before the source and the padding after it
+  size_t ownerBytes =
+      sizeof(PaddedString) + 1 + view.size() + PaddedString::padding;
+  return Document(root, view, std::move(owner), ownerBytes);
+}
+
+template Document Parse<dialect::CommonMark>(std::string_view);
+template Document Parse<dialect::GFM>(std::string_view);
+
+template <Extension Ext>
+Document ParseFile(const std::string& path) {
+  auto file = std::make_shared<MappedFile>();
+  if (!file->Open(path, true)) {
+    throw std::system_error(errno, std::generic_category(),
+                            "parsemd: cannot map " + path);
+  }
+
+  Node root = ParseScratch<Ext>(file->View());
+  std::string_view source = file->View();
+  return Document(root, source, std::move(file));
+}
+
+template Document ParseFile<dialect::CommonMark>(const std::string&);
+template Document ParseFile<dialect::GFM>(const std::string&);
+
+LazyDocument::LazyDocument()
+    : LazyDocument(std::make_shared<BlockNode>(TokenType::Root),
+                   {},
+                   nullptr,
+                   nullptr) {}
+
+LazyDocument::LazyDocument(Node blocks,
+                           std::string_view source,
+                           std::shared_ptr<const void> owner,
+                           Expander expand)
+    : blocks_(std::move(blocks)),
+      source_(source),
+      owner_(std::move(owner)),
+      expand_(expand),
+      slots_(std::make_unique<Slot[]>(Size())),
+      root_(std::make_unique<Slot>()) {}
+
+// Block and its block children (table rows and cells), inline content still
+// unparsed
+Block LazyDocument::CopyBlock(const BlockNode& block) {
+  const TableCellNode* cell = TableCellNodePtr(&block);
+  Block copy = cell ? std::make_shared<TableCellNode>(cell->align)
+                    : std::make_shared<BlockNode>(block.type_);
+  copy->text_ = block.text_;
+#ifdef PARSEMD_SOURCE_POS
+  copy->source_ = block.source_;
+#endif
+  copy->children.reserve(block.children.size());
+  for (const Node& child : block.children) {
+    copy->children.push_back(CopyBlock(*BlockNodePtr(child.get())));
+  }
+  return copy;
+}
+
+const NodeBase& LazyDocument::Blocks() const {
+  return *blocks_;
+}
+
+size_t LazyDocument::Size() const {
+  return ContainerNodePtr(blocks_.get())->children.size();
+}
+
+const NodeBase& LazyDocument::At(size_t i) const {
+  Slot& slot = slots_[i];
+  std::call_once(slot.once, [&] {
+    const Node& block = ContainerNodePtr(blocks_.get())->children[i];
+    Block copy = CopyBlock(*BlockNodePtr(block.get()));
+    expand_(source_, copy);
+    slot.node = copy;
+  });
+  return *slot.node;
+}
+
+const NodeBase& LazyDocument::Root() const {
+  std::call_once(root_->once, [&] {
+    Block root = std::make_shared<BlockNode>(TokenType::Root);
+#ifdef PARSEMD_SOURCE_POS
+    root->source_ = blocks_->source_;
+#endif
+    root->children.reserve(Size());
+    for (size_t i = 0; i < Size(); i++) {
+      At(i);
+      root->children.push_back(slots_[i].node);
+    }
+#ifdef PARSEMD_NODE_HASH
+    root->hash_ = internal::NodeSeedHash(*root);
+    for (const Node& child : root->children) {
+      root->hash_ = internal::HashCombine(root->hash_, child->hash_);
+    }
+#endif
+    root_->node = root;
+  });
+  return *root_->node;
+}
+
+std::string_view LazyDocument::Source() const {
+  return source_;
+}
+
+template <Extension Ext>
+static void ExpandScratch(std::string_view source, const Block& block) {
+  thread_local BasicParser<Ext> parser;
+  parser.BorrowDocument(source);
+  parser.AnalyzeInline(block);
+  parser.Reset();
+}
+
+template <Extension Ext>
+LazyDocument ParseLazy(std::string_view source) {
+  auto owner = std::make_shared<const std::string>(source);
+  std::string_view view = *owner;
+  Node blocks = ParseScratch<Ext>(view, false);
+  return LazyDocument(blocks, view, std::move(owner), &ExpandScratch<Ext>);
+}
+
+template LazyDocument ParseLazy<dialect::CommonMark>(std::string_view);
+template LazyDocument ParseLazy<dialect::GFM>(std::string_view);
+
+}  // namespace markdown
@@ -0,0 +1,124 @@
+#include "parsemd/flattree.h"
+#include "parsemd/cursor.h"
+#include "parsemd/node.h"
+
+namespace markdown {
+
+FlatTree::FlatTree() {}
+FlatTree::FlatTree(const NodeBase& root, bool typeColumn) {
+  Build(root, typeColumn);
+}
+FlatTree::FlatTree(const Node& root, bool typeColumn) {
+  if (root) {
+    Build(*root, typeColumn);
+  }
+}
+
+void FlatTree::Build(const NodeBase& root, bool typeColumn) {
+  Clear();
+  // indices of the containers entered but not exited yet
+  std::vector<uint32_t> open;
+  Cursor cursor(root, maxDepth);
+  while (cursor.Next()) {
+    if (cursor.GetEvent() == Cursor::Exit) {
+      nodes_[open.back()].end = nodes_.size();
+      open.pop_back();
+      continue;
+    }
+
+    const NodeBase& node = cursor.Current();
+    std::string_view text;
+    FlatNode record = {};
+    record.type = static_cast<uint8_t>(node.Type());
+    record.depth = cursor.Depth();
+    record.end = nodes_.size() + 1;
+    if (const TextNode* tnode = TextNodePtr(&node)) {
+      text = tnode->text;
+    } else {
+      open.push_back(nodes_.size());
+      const BlockNode* bnode = BlockNodePtr(&node);
+      if (bnode && node.Type() != TokenType::Root) {
+        text = bnode->RawText();
+      }
+      if (const TableCellNode* cell = TableCellNodePtr(&node)) {
+        record.align = static_cast<uint8_t>(cell->align);
+      }
+    }
+    record.text = strings_.size();
+    record.textSize = text.size();
+    strings_.append(text);
+    nodes_.push_back(record);
+#ifdef PARSEMD_SOURCE_POS
+    sources_.push_back(node.Source());
+#endif
+  }
+  truncated_ = cursor.Truncated();
+
+  if (typeColumn) {
+    types_.reserve(nodes_.size());
+    for (const FlatNode& node : nodes_) {
+      types_.push_back(node.type);
+    }
+  }
+}
+
+void FlatTree::Clear() {
+  nodes_.clear();
+  types_.clear();
+  strings_.clear();
+  truncated_ = false;
+#ifdef PARSEMD_SOURCE_POS
+  sources_.clear();
+#endif
+}
+
+size_t FlatTree::Size() const {
+  return nodes_.size();
+}
+bool FlatTree::Truncated() const {
+  return truncated_;
+}
+const std::vector<FlatNode>& FlatTree::Nodes() const {
+  return nodes_;
+}
+const FlatNode& FlatTree::operator[](uint32_t index) const {
+  return nodes_[index];
+}
+
+TokenType FlatTree::Type(uint32_t index) const {
+  return static_cast<TokenType>(nodes_[index].type);
+}
+Alignment FlatTree::Align(uint32_t index) const {
+  return static_cast<Alignment>(nodes_[index].align);
+}
+std::string_view FlatTree::Text(uint32_t index) const {
+  const FlatNode& node = nodes_[index];
+  return std::string_view(strings_).substr(node.text, node.textSize);
+}
+SourceRange FlatTree::Source([[maybe_unused]] uint32_t index) const {
+#ifdef PARSEMD_SOURCE_POS
+  return sources_[index];
+#else
+  return {};
+#endif
+}
+
+uint32_t FlatTree::FirstChild(uint32_t index) const {
+  return index + 1 < nodes_[index].end ? index + 1 : npos;
+}
+uint32_t FlatTree::NextSibling(uint32_t index) const {
+  uint32_t next = nodes_[index].end;
+  if (next < nodes_.size() && nodes_[next].depth == nodes_[index].depth) {
+    return next;
+  }
+  return npos;
+}
+
+const std::vector<uint8_t>& FlatTree::Types() const {
+  return types_;
+}
+std::string_view FlatTree::Strings() const {
+  return strings_;
+}
+
+}  // namespace markdown
@@ -0,0 +1,176 @@
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <thread>
+
+#include "parsemd/html.h"
+#include "parsemd/node.h"
+
+namespace markdown {
+
+// Bytes that cannot appear verbatim in HTML text or attribute values
+static constexpr std::array<bool, 256> MakeHtmlEscapes() {
+  std::array<bool, 256> escapes = {};
+  for (int c = 0; c < 256; c++) {
+    escapes[c] = !internal::HtmlEscape(static_cast<char>(c)).empty();
+  }
+  return escapes;
+}
+static constexpr std::array<bool, 256> htmlEscapes = MakeHtmlEscapes();
+
+HtmlWriter::HtmlWriter(HtmlSink sink, size_t bufferSize)
+    : sink_(std::move(sink)),
+      bufferSize_(bufferSize ? bufferSize : 1),
+      cursor_(SIZE_MAX) {
+  buffer_.reserve(bufferSize_);
+}
+
+void HtmlWriter::Write(const Node& root) {
+  if (root) {
+    Write(*root);
+  }
+}
+
+void HtmlWriter::Write(const NodeBase& root) {
+  auto append = [this](std::string_view sv) { Append(sv); };
+  markup_.Reset();
+  for (cursor_.Reset(root); cursor_.Next();) {
+    const NodeBase& current = cursor_.Current();
+    if (const TextNode* text = TextNodePtr(&current)) {
+      AppendEscaped(text->text);
+      markup_.Text(text->text);
+    } else if (cursor_.GetEvent() == Cursor::Enter) {
+      const TableCellNode* cell = TableCellNodePtr(&current);
+      markup_.Open(current.Type(), cell ? cell->align : Alignment::None,
+                   append);
+      if (current.Type() == TokenType::Codeblock) {
+        AppendEscaped(BlockNodePtr(&current)->RawText());
+      }
+    } else {
+      markup_.Close(current.Type(), append);
+    }
+  }
+  Flush();
+}
+
+void HtmlWriter::Append(std::string_view sv) {
+  buffer_.append(sv);
+  if (buffer_.size() >= bufferSize_) {
+    Flush();
+  }
+}
+
+// Copies runs of plain bytes in one go, UTF-8 passes through unchanged
+void HtmlWriter::AppendEscaped(std::string_view sv) {
+  const char* run = sv.data();
+  const char* end = sv.data() + sv.size();
+  for (const char* it = run; it != end; it++) {
+    unsigned char c = *it;
+    if (!htmlEscapes[c]) {
+      continue;
+    }
+    buffer_.append(run, it - run);
+    buffer_.append(internal::HtmlEscape(c));
+    run = it + 1;
+  }
+  Append(std::string_view(run, end - run));
+}
+
+void HtmlWriter::Flush() {
+  if (!buffer_.empty()) {
+    sink_(buffer_);
+    buffer_.clear();
+  }
+}
+
+void ToHtml(const NodeBase& root, std::string& out) {
+  out.clear();
+  HtmlWriter writer([&out](std::string_view chunk) { out.append(chunk); });
+  writer.Write(root);
+}
+
+std::string ToHtml(const Node& root) {
+  std::string out;
+  if (root) {
+    ToHtml(*root, out);
+  }
+  return out;
+}
+
+std::vector<std::string> ToHtmlChunks(const NodeBase& root, size_t threads) {
+  std::vector<std::string> chunks;
+  const ContainerNode* container = ContainerNodePtr(&root);
+  size_t blocks = container ? container->children.size() : 0;
+  // a few runs per thread, so one with slow blocks does not hold up the rest
+  size_t count = std::min(blocks, threads * 4);
+  if (root.Type() != TokenType::Root || threads <= 1 || count <= 1) {
+    chunks.emplace_back();
+    ToHtml(root, chunks.back());
+    return chunks;
+  }
+
+  chunks.resize(count);
+  std::atomic<size_t> next = 0;
+  // the first exception of any thread, rethrown once all are joined
+  std::exception_ptr error;
+  std::mutex errorMutex;
+  // the root itself renders to nothing, so its blocks can be written apart
+  auto work = [&] {
+    try {
+      std::string* target = nullptr;
+      HtmlWriter writer(
+          [&](std::string_view chunk) { target->append(chunk); });
+      for (size_t i; (i = next++) < count;) {
+        target = &chunks[i];
+        for (size_t b = blocks * i / count; b < blocks * (i + 1) / count;
+             b++) {
+          writer.Write(*container->children[b]);
+        }
+      }
+    } catch (...) {
+      std::lock_guard<std::mutex> lock(errorMutex);
+      if (!error) {
+        error = std::current_exception();
+      }
+      next = count;
+    }
+  };
+  std::vector<std::thread> workers;
+  for (size_t t = 1; t < std::min(threads, count); t++) {
+    try {
+      workers.emplace_back(work);
+    } catch (...) {
+      // the threads already running take the remaining runs
+      break;
+    }
+  }
+  work();
+  for (std::thread& worker : workers) {
+    worker.join();
+  }
+  if (error) {
+    std::rethrow_exception(error);
+  }
+  return chunks;
+}
+
+void ToHtmlParallel(const NodeBase& root, std::string& out, size_t threads) {
+  std::vector<std::string> chunks = ToHtmlChunks(root, threads);
+  if (chunks.size() == 1) {
+    out = std::move(chunks[0]);
+    return;
+  }
+  size_t size = 0;
+  for (const std::string& chunk : chunks) {
+    size += chunk.size();
+  }
+  out.clear();
+  out.reserve(size);
+  for (const std::string& chunk : chunks) {
+    out.append(chunk);
+  }
+}
+
+}  // namespace markdown
@@ -1,7 +1,10 @@
-#include <iomanip>
-#include <iostream>
+#include <cstring>
 #include <string>
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
 #include "parsemd/internal.h"
 
 namespace markdown {
@@ -12,98 +15,129 @@ TokenType GetMarker(std::string_view marker) {
     if (m.marker == marker)
       return m.type;
   }
-  // clang-format off
-  if (
-    marker[0] == '*' ||
-    marker[0] == '_'
-    // || marker[0] == '#'
-  ) {  // clang-format on
+  if (IsDelimiter(marker[0])) {
     return TokenType::None;
   }
   return TokenType::Text;
 }
 
-bool IsDelimiter(char c) {
-  // clang-format off
-  switch (c) {
-    case '*': return true;
-    case '_': return true;
-    // case '#': return true;
+size_t FindTablePipe(std::string_view row, size_t pos) {
+  const char* data = row.data();
+  size_t size = row.size();
+
+#if defined(__SSE2__)
+  const __m128i pipe = _mm_set1_epi8('|');
+  for (; pos + 16 <= size; pos += 16) {
+    __m128i chunk =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + pos));
+    unsigned mask = _mm_movemask_epi8(_mm_cmpeq_epi8(chunk, pipe));
+    while (mask) {
+      size_t idx = pos + __builtin_ctz(mask);
+      if (!IsEscaped(row, idx)) {
+        return idx;
+      }
+      mask &= mask - 1;
+    }
   }
-  // clang-format on
-  return false;
-}
+#endif
 
-bool IsValidDelimiter(char prev, char delim, char next) {
-  if (!(delim == '*' || delim == '_')) {
-    std::cerr << "Unhandled Delimiter: " << std::quoted(std::to_string(delim))
-              << std::endl;
-    std::exit(1);
+  for (; pos < size; pos++) {
+    if (data[pos] == '|' && !IsEscaped(row, pos)) {
+      return pos;
+    }
   }
-
-  return IsLeftFlanking(prev, next) || IsRightFlanking(prev, next);
+  return std::string_view::npos;
 }
 
-bool IsWhitespace(char c) {
-  return (c == ' ' || c == '\t' || c == '\n' || c == '\r') ? true : false;
-}
-
-bool IsPunctuation(char c) {
-  // ASCII only
-  if (c >= 33 && c <= 47)
-    return true;
-  else if (c >= 58 && c <= 64)
-    return true;
-  else if (c >= 91 && c <= 96)
-    return true;
-  else if (c >= 123 && c <= 126)
-    return true;
-
-  return false;
-}
-
-bool IsLeftFlanking(char prev, char next) {
-  // NOTE: No Unicode support
-  if (IsWhitespace(next)) {
-    return false;
+// https://github.github.com/gfm/#tables-extension-
+void SplitTableRow(std::string_view row,
+                   std::pmr::vector<std::string_view>& cells) {
+  cells.clear();
+  htrim(row);
+  if (!row.empty() && row.front() == '|') {
+    row.remove_prefix(1);
   }
 
-  if (IsPunctuation(next) && !(IsWhitespace(prev) || IsPunctuation(prev))) {
-    return false;
+  size_t begin = 0, pipe;
+  while ((pipe = FindTablePipe(row, begin)) != std::string_view::npos) {
+    std::string_view cell = row.substr(begin, pipe - begin);
+    htrim(cell);
+    cells.push_back(cell);
+    begin = pipe + 1;
   }
 
-  return true;
+  // a trailing pipe closes the row instead of opening an empty cell
+  if (begin < row.size() || cells.empty()) {
+    std::string_view cell = row.substr(begin);
+    htrim(cell);
+    cells.push_back(cell);
+  }
 }
 
-bool IsRightFlanking(char prev, char next) {
-  // NOTE: No Unicode support
-  if (IsWhitespace(prev)) {
+bool ParseTableDelimiterRow(std::string_view row,
+                            std::pmr::vector<std::string_view>& cells,
+                            std::pmr::vector<Alignment>& aligns) {
+  aligns.clear();
+  if (row.find('|') == std::string_view::npos) {
     return false;
   }
 
-  if (IsPunctuation(prev) && !(IsWhitespace(next) || IsPunctuation(next))) {
-    return false;
+  SplitTableRow(row, cells);
+  for (std::string_view cell : cells) {
+    Alignment align = Alignment::None;
+    if (!ParseTableDelimiterCell(cell, align)) {
+      return false;
+    }
+    aligns.push_back(align);
   }
-
   return true;
 }
 
-void htrim(std::string_view& sv) {
-  std::string_view::iterator it = sv.begin();
-  int count = 0;
-  while ((it + count) != sv.end() && IsWhitespace(*(it + count))) {
-    count++;
+// 64x64 -> 128 bit multiply folded back to 64 bits (wyhash style mixing)
+static uint64_t Mix(uint64_t a, uint64_t b) {
+  __uint128_t r = static_cast<__uint128_t>(a) * b;
+  return static_cast<uint64_t>(r) ^ static_cast<uint64_t>(r >> 64);
+}
+
+static uint64_t Read64(const char* p) {
+  uint64_t v;
+  std::memcpy(&v, p, sizeof(v));
+  return v;
+}
+
+uint64_t Hash64(std::string_view data, uint64_t seed) {
+  constexpr uint64_t k0 = 0xa0761d6478bd642full;
+  constexpr uint64_t k1 = 0xe7037ed1a0b428dbull;
+  constexpr uint64_t k2 = 0x8ebc6af09c88c6e3ull;
+  constexpr uint64_t k3 = 0x589965cc75374cc3ull;
+
+  const char* p = data.data();
+  size_t n = data.size();
+  uint64_t h = seed ^ k0;
+
+  // two independent lanes of 16 bytes for long inputs
+  if (n >= 32) {
+    uint64_t h1 = h ^ k3;
+    for (; n >= 32; p += 32, n -= 32) {
+      h = Mix(Read64(p) ^ k1, Read64(p + 8) ^ h);
+      h1 = Mix(Read64(p + 16) ^ k2, Read64(p + 24) ^ h1);
+    }
+    h ^= h1;
+  }
+  for (; n >= 8; p += 8, n -= 8) {
+    h = Mix(Read64(p) ^ k1, h ^ k2);
   }
-  sv.remove_prefix(count);
-
-  if (sv.size() == 0)
-    return;
-  count = sv.size() - 1;
-  it = sv.begin();
-  while ((it + count) != sv.end() && IsWhitespace(*(it + count))) {
-    count--;
+
+  uint64_t tail = 0;
+  if (n) {
+    std::memcpy(&tail, p, n);
   }
-  sv.remove_suffix(sv.size() - count - 1);
+  h = Mix(tail ^ k3, h ^ n);
+  return Mix(h ^ data.size(), k1);
+}
+
+uint64_t HashCombine(uint64_t seed, uint64_t value) {
+  return Mix(seed ^ 0x2d358dccaa6c78a5ull, value ^ 0x8bb84b93962eacc9ull);
 }
 
 TokenList::iterator listIteratorAdvance(TokenList::iterator& it, int inc) {
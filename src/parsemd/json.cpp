@@ -0,0 +1,182 @@
+#include <array>
+#include <charconv>
+
+#include "parsemd/json.h"
+#include "parsemd/node.h"
+
+namespace markdown {
+
+// Bytes that cannot appear verbatim inside a JSON string
+static constexpr std::array<bool, 256> MakeJsonEscapes() {
+  std::array<bool, 256> escapes = {};
+  for (int c = 0; c < 0x20; c++) {
+    escapes[c] = true;
+  }
+  escapes['"'] = true;
+  escapes['\\'] = true;
+  return escapes;
+}
+static constexpr std::array<bool, 256> jsonEscapes = MakeJsonEscapes();
+
+static std::string_view AlignName(Alignment align) {
+  switch (align) {
+    case Alignment::Left:
+      return "left";
+    case Alignment::Center:
+      return "center";
+    case Alignment::Right:
+      return "right";
+    default:
+      return "";
+  }
+}
+
+JsonWriter::JsonWriter(JsonSink sink, size_t bufferSize)
+    : sink_(std::move(sink)),
+      bufferSize_(bufferSize ? bufferSize : 1),
+      cursor_(SIZE_MAX) {
+  buffer_.reserve(bufferSize_);
+}
+
+void JsonWriter::Write(const Node& root) {
+  if (root) {
+    Write(*root);
+  }
+}
+
+void JsonWriter::Write(const NodeBase& root) {
+  // whether the innermost open array has no element yet
+  bool first = true;
+  for (cursor_.Reset(root); cursor_.Next();) {
+    if (cursor_.GetEvent() == Cursor::Exit) {
+      Append("]}");
+      first = false;
+      continue;
+    }
+    if (!first) {
+      Append(",");
+    }
+    first = Open(cursor_.Current());
+  }
+  Flush();
+}
+
+// Writes everything up to the children and leaves their array open, false
+// for text nodes, which are closed right away
+bool JsonWriter::Open(const NodeBase& node) {
+  std::string_view type = TokenStrView(node.Type());
+  type.remove_prefix(type.find(':') + 2);  // "Token::"
+  Append("{\"type\":\"");
+  Append(type);
+  Append("\"");
+
+  std::string_view text;
+  const TextNode* tnode = TextNodePtr(&node);
+  const BlockNode* bnode = BlockNodePtr(&node);
+  if (tnode) {
+    text = tnode->text;
+  } else if (bnode && node.Type() != TokenType::Root) {
+    text = bnode->RawText();
+  }
+  if (!text.empty()) {
+    Append(",\"text\":\"");
+    AppendEscaped(text);
+    Append("\"");
+  }
+
+  if (const TableCellNode* cell = TableCellNodePtr(&node)) {
+    if (cell->align != Alignment::None) {
+      Append(",\"align\":\"");
+      Append(AlignName(cell->align));
+      Append("\"");
+    }
+  }
+
+#ifdef PARSEMD_SOURCE_POS
+  Append(",\"source\":[");
+  AppendNumber(node.Source().begin);
+  Append(",");
+  AppendNumber(node.Source().end);
+  Append("]");
+#endif
+
+  if (tnode) {
+    Append("}");
+    return false;
+  }
+  Append(",\"children\":[");
+  return true;
+}
+
+void JsonWriter::Append(std::string_view sv) {
+  buffer_.append(sv);
+  if (buffer_.size() >= bufferSize_) {
+    Flush();
+  }
+}
+
+// Copies runs of plain bytes in one go, UTF-8 passes through unchanged
+void JsonWriter::AppendEscaped(std::string_view sv) {
+  static constexpr char hex[] = "0123456789abcdef";
+  const char* run = sv.data();
+  const char* end = sv.data() + sv.size();
+  for (const char* it = run; it != end; it++) {
+    unsigned char c = *it;
+    if (!jsonEscapes[c]) {
+      continue;
+    }
+    buffer_.append(run, it - run);
+    run = it + 1;
+    switch (c) {
+      case '"':
+        buffer_.append("\\\"");
+        break;
+      case '\\':
+        buffer_.append("\\\\");
+        break;
+      case '\n':
+        buffer_.append("\\n");
+        break;
+      case '\r':
+        buffer_.append("\\r");
+        break;
+      case '\t':
+        buffer_.append("\\t");
+        break;
+      default:
+        buffer_.append("\\u00");
+        buffer_ += hex[c >> 4];
+        buffer_ += hex[c & 0xf];
+    }
+  }
+  Append(std::string_view(run, end - run));
+}
+
+void JsonWriter::AppendNumber(uint32_t value) {
+  char digits[10];
+  auto [end, ec] = std::to_chars(digits, digits + sizeof(digits), value);
+  Append(std::string_view(digits, end - digits));
+}
+
+void JsonWriter::Flush() {
+  if (!buffer_.empty()) {
+    sink_(buffer_);
+    buffer_.clear();
+  }
+}
+
+void ToJson(const NodeBase& root, std::string& out) {
+  out.clear();
+  JsonWriter writer([&out](std::string_view chunk) { out.append(chunk); });
+  writer.Write(root);
+}
+
+std::string ToJson(const Node& root) {
+  std::string out;
+  if (root) {
+    ToJson(*root, out);
+  }
+  return out;
+}
+
+}  // namespace markdown
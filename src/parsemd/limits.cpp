@@ -0,0 +1,27 @@
+#include "parsemd/limits.h"
+
+namespace markdown {
+
+std::string_view ParseLimits::LimitName(Limit limit) {
+  switch (limit) {
+    case None:
+      return "none";
+    case InputSize:
+      return "input size";
+    case Depth:
+      return "depth";
+    case Tokens:
+      return "tokens";
+    case Delimiters:
+      return "delimiters";
+    case Nodes:
+      return "nodes";
+    case Deadline:
+      return "deadline";
+    case Cancelled:
+      return "cancelled";
+  }
+  return "";
+}
+
+}  // namespace markdown
@@ -0,0 +1,46 @@
+#include <algorithm>
+#include <cstring>
+
+#include "parsemd/lineindex.h"
+
+namespace markdown {
+
+LineIndex::LineIndex() {
+  Init("");
+}
+LineIndex::LineIndex(std::string_view doc) {
+  Init(doc);
+}
+
+void LineIndex::Init(std::string_view doc) {
+  lineBegins_.clear();
+  lineBegins_.push_back(0);
+
+  const char* begin = doc.data();
+  const char* end = begin + doc.size();
+  const char* it = begin;
+  while (it != end &&
+         (it = static_cast<const char*>(std::memchr(it, '\n', end - it)))) {
+    ++it;
+    lineBegins_.push_back(std::distance(begin, it));
+  }
+}
+
+LineIndex::Position LineIndex::Locate(uint32_t offset) const {
+  auto it = std::upper_bound(lineBegins_.begin(), lineBegins_.end(), offset);
+  uint32_t line = std::distance(lineBegins_.begin(), it);
+  return {line, offset - lineBegins_[line - 1] + 1};
+}
+
+uint32_t LineIndex::LineBegin(uint32_t line) const {
+  if (line == 0 || line > lineBegins_.size()) {
+    return 0;
+  }
+  return lineBegins_[line - 1];
+}
+
+size_t LineIndex::Lines() const {
+  return lineBegins_.size();
+}
+
+}  // namespace markdown
@@ -0,0 +1,91 @@
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <utility>
+
+#include "parsemd/mappedfile.h"
+
+namespace markdown {
+
+MappedFile::MappedFile() {}
+MappedFile::MappedFile(const std::string& path, bool sequential) {
+  Open(path, sequential);
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept {
+  *this = std::move(other);
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+  if (this != &other) {
+    Close();
+    data_ = std::exchange(other.data_, nullptr);
+    size_ = std::exchange(other.size_, 0);
+    open_ = std::exchange(other.open_, false);
+  }
+  return *this;
+}
+
+MappedFile::~MappedFile() {
+  Close();
+}
+
+bool MappedFile::Open(const std::string& path, bool sequential) {
+  Close();
+  int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0) {
+    return false;
+  }
+
+  struct stat st;
+  if (::fstat(fd, &st) < 0) {
+    ::close(fd);
+    return false;
+  }
+
+  // mmap rejects empty mappings, an empty file is an empty view
+  size_t size = st.st_size;
+  if (size > 0) {
+    if (sequential) {
+      ::posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+    }
+    void* data = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (data == MAP_FAILED) {
+      ::close(fd);
+      return false;
+    }
+    if (sequential) {
+      ::madvise(data, size, MADV_SEQUENTIAL);
+    }
+    data_ = static_cast<const char*>(data);
+  }
+  ::close(fd);
+
+  size_ = size;
+  open_ = true;
+  return true;
+}
+
+void MappedFile::Close() {
+  if (data_) {
+    ::munmap(const_cast<char*>(data_), size_);
+  }
+  data_ = nullptr;
+  size_ = 0;
+  open_ = false;
+}
+
+bool MappedFile::IsOpen() const {
+  return open_;
+}
+
+std::string_view MappedFile::View() const {
+  return std::string_view(data_, size_);
+}
+
+size_t MappedFile::Size() const {
+  return size_;
+}
+
+}  // namespace markdown
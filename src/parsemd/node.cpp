@@ -1,5 +1,6 @@
 #include "parsemd/node.h"
 #include <memory>
+#include "parsemd/internal.h"
 #include "parsemd/types.h"
 
 namespace markdown {
@@ -8,16 +9,43 @@ NodeBase::NodeBase(TokenType type) : type_(type) {}
 TokenType NodeBase::Type() const {
   return type_;
 }
+SourceRange NodeBase::Source() const {
+#ifdef PARSEMD_SOURCE_POS
+  return source_;
+#else
+  return {};
+#endif
+}
+uint64_t NodeBase::Hash() const {
+#ifdef PARSEMD_NODE_HASH
+  return hash_;
+#else
+  return 0;
+#endif
+}
 
-ContainerNode::ContainerNode(TokenType type) : NodeBase(type) {}
+ContainerNode::ContainerNode(TokenType type,
+                             std::pmr::memory_resource* resource)
+    : NodeBase(type), children(resource) {}
 
 BlockNode::BlockNode() : ContainerNode(TokenType::None) {}
-BlockNode::BlockNode(TokenType type) : ContainerNode(type) {}
+BlockNode::BlockNode(TokenType type, std::pmr::memory_resource* resource)
+    : ContainerNode(type, resource) {}
+std::string_view BlockNode::RawText() const {
+  return text_;
+}
+
+TableCellNode::TableCellNode(Alignment align,
+                             std::pmr::memory_resource* resource)
+    : BlockNode(TokenType::TableCell, resource), align(align) {}
 
-InlineNode::InlineNode(TokenType type) : ContainerNode(type) {}
+InlineNode::InlineNode(TokenType type, std::pmr::memory_resource* resource)
+    : ContainerNode(type, resource) {}
 
-TextNode::TextNode(TokenType type, std::string text)
-    : NodeBase(type), text(text) {}
+TextNode::TextNode(TokenType type,
+                   std::string_view text,
+                   std::pmr::memory_resource* resource)
+    : NodeBase(type), text(text, resource) {}
 
 std::shared_ptr<ContainerNode> ContainerNodePtr(Node node) {
   if (!node.get())
@@ -51,4 +79,60 @@ std::shared_ptr<TextNode> TextNodePtr(Node node) {
   return std::static_pointer_cast<TextNode>(node);
 }
 
+std::shared_ptr<TableCellNode> TableCellNodePtr(Node node) {
+  if (!node.get())
+    return nullptr;
+  if (node->Type() != TokenType::TableCell)
+    return nullptr;
+  return std::static_pointer_cast<TableCellNode>(node);
+}
+
+const ContainerNode* ContainerNodePtr(const NodeBase* node) {
+  if (!node || IsText(node->Type()))
+    return nullptr;
+  return static_cast<const ContainerNode*>(node);
+}
+
+const BlockNode* BlockNodePtr(const NodeBase* node) {
+  if (!node || !IsBlock(node->Type()))
+    return nullptr;
+  return static_cast<const BlockNode*>(node);
+}
+
+const InlineNode* InlineNodePtr(const NodeBase* node) {
+  if (!node || !IsInline(node->Type()) || IsText(node->Type()))
+    return nullptr;
+  return static_cast<const InlineNode*>(node);
+}
+
+const TextNode* TextNodePtr(const NodeBase* node) {
+  if (!node || !IsText(node->Type()))
+    return nullptr;
+  return static_cast<const TextNode*>(node);
+}
+
+const TableCellNode* TableCellNodePtr(const NodeBase* node) {
+  if (!node || node->Type() != TokenType::TableCell)
+    return nullptr;
+  return static_cast<const TableCellNode*>(node);
+}
+
+namespace internal {
+
+uint64_t NodeSeedHash(const NodeBase& node) {
+  uint64_t seed = static_cast<uint64_t>(node.Type());
+  if (const TableCellNode* cell = TableCellNodePtr(&node)) {
+    seed |= static_cast<uint64_t>(cell->align) << 8;
+  }
+  if (const TextNode* text = TextNodePtr(&node)) {
+    return Hash64(text->text, seed);
+  }
+  if (const BlockNode* block = BlockNodePtr(&node)) {
+    return Hash64(block->RawText(), seed);
+  }
+  return HashCombine(seed, 0);
+}
+
+}  // namespace internal
+
 }  // namespace markdown
@@ -0,0 +1,105 @@
+#include <cstring>
+#include <utility>
+
+#include "parsemd/padded.h"
+
+namespace markdown {
+
+// Stands in for the buffer of a moved from string
+static const char noBuffer[1 + PaddedString::padding] = {};
+
+// The string starts at buffer_ + 1
+PaddedString::PaddedString()
+    : PaddedString(std::pmr::get_default_resource()) {}
+
+PaddedString::PaddedString(std::pmr::memory_resource* resource)
+    : resource_(resource) {
+  Assign({});
+}
+
+PaddedString::PaddedString(std::string_view str,
+                           std::pmr::memory_resource* resource)
+    : resource_(resource) {
+  Assign(str);
+}
+
+PaddedString::PaddedString(const PaddedString& other)
+    : resource_(std::pmr::get_default_resource()) {
+  Assign(other.View());
+}
+
+PaddedString::PaddedString(PaddedString&& other) noexcept
+    : resource_(other.resource_),
+      buffer_(std::exchange(other.buffer_, nullptr)),
+      size_(std::exchange(other.size_, 0)),
+      capacity_(std::exchange(other.capacity_, 0)) {}
+
+PaddedString& PaddedString::operator=(const PaddedString& other) {
+  if (this != &other) {
+    Assign(other.View());
+  }
+  return *this;
+}
+
+PaddedString& PaddedString::operator=(PaddedString&& other) noexcept {
+  if (this != &other) {
+    Free();
+    resource_ = other.resource_;
+    buffer_ = std::exchange(other.buffer_, nullptr);
+    size_ = std::exchange(other.size_, 0);
+    capacity_ = std::exchange(other.capacity_, 0);
+  }
+  return *this;
+}
+
+PaddedString::~PaddedString() {
+  Free();
+}
+
+void PaddedString::Assign(std::string_view str) {
+  if (!buffer_ || str.size() > capacity_) {
+    Free();
+    capacity_ = str.size();
+    buffer_ =
+        static_cast<char*>(resource_->allocate(1 + capacity_ + padding, 1));
+  }
+  size_ = str.size();
+  buffer_[0] = '\0';
+  if (size_) {
+    std::memcpy(buffer_ + 1, str.data(), size_);
+  }
+  std::memset(buffer_ + 1 + size_, 0, padding);
+}
+
+void PaddedString::Clear() {
+  Assign({});
+}
+
+void PaddedString::Free() {
+  if (buffer_) {
+    resource_->deallocate(buffer_, 1 + capacity_ + padding, 1);
+    buffer_ = nullptr;
+  }
+}
+
+const char* PaddedString::data() const {
+  return (buffer_ ? buffer_ : noBuffer) + 1;
+}
+
+size_t PaddedString::size() const {
+  return size_;
+}
+
+bool PaddedString::empty() const {
+  return size_ == 0;
+}
+
+std::string_view PaddedString::View() const {
+  return std::string_view(data(), size_);
+}
+
+PaddedString::operator std::string_view() const {
+  return View();
+}
+
+}  // namespace markdown
@@ -1,31 +1,72 @@
 #include "parsemd/parser.h"
+#include "parsemd/cursor.h"
 #include "parsemd/delimiterstack.h"
 #include "parsemd/internal.h"
 #include "parsemd/node.h"
 #include "parsemd/types.h"
 #include "parsemd/utils.h"
 
-#include <cstdlib>
-#include <iomanip>
-#include <iostream>
+#include <algorithm>
 #include <memory>
 #include <string>
 #include <string_view>
 
 namespace markdown {
 
-Parser::Parser() {}
+template <Extension Ext>
+BasicParser<Ext>::BasicParser()
+    : BasicParser(std::pmr::get_default_resource()) {}
+
+template <Extension Ext>
+BasicParser<Ext>::BasicParser(std::pmr::memory_resource* resource)
+    : delimStack(resource),
+      resource_(resource),
+      storage_(resource),
+      candTokens_(resource),
+      cells_(resource),
+      aligns_(resource),
+      diagnostics_(Diagnostics::defaultCapacity, resource) {}
+
+template <Extension Ext>
+std::pmr::memory_resource* BasicParser<Ext>::Resource() const {
+  return resource_;
+}
 
-Node Parser::GetBlock() {
+template <Extension Ext>
+Node BasicParser<Ext>::GetBlock() {
   return std::static_pointer_cast<NodeBase>(block_);
 }
 
-void Parser::AssignDocument(std::string_view doc) {
-  scanner.Init(doc);
-  document_ = doc;
+template <Extension Ext>
+void BasicParser<Ext>::AssignDocument(std::string_view doc) {
+  // only the part within the limit is copied
+  storage_.Assign(LimitInput(doc));
+  BorrowDocument(storage_);
+  if (storage_.size() < doc.size()) {
+    truncated_ = ParseLimits::InputSize;
+  }
+}
+
+template <Extension Ext>
+void BasicParser<Ext>::BorrowDocument(std::string_view doc) {
+  document_ = LimitInput(doc);
+  truncated_ = document_.size() < doc.size() ? ParseLimits::InputSize
+                                             : ParseLimits::None;
+  scanner.Init(document_);
+  scanner.SetDiagnostics(&diagnostics_);
+  diagnostics_.Begin(document_);
+  padded_ = false;
+  nodes_ = 0;
 }
 
-Node Parser::BuildBlocks() {
+template <Extension Ext>
+void BasicParser<Ext>::BorrowDocument(const PaddedString& doc) {
+  BorrowDocument(doc.View());
+  padded_ = true;
+}
+
+template <Extension Ext>
+Node BasicParser<Ext>::BuildBlocks() {
   std::string_view line;
   while ((line = scanner.ScanNextLine()) != "" || !scanner.End()) {
     if (line.empty()) {
@@ -37,17 +78,20 @@ Node Parser::BuildBlocks() {
       continue;
     }
     // lets not care about whitespace count rn (codeblock burn)
-    if (line[pos] == '#') {
-      Scanner scnr(line);
-      int count = scnr.LookAhead(Scanner::CurPos::Begin, pos);
-      std::string_view marker(line.begin() + pos, count);
-
-      if (scnr.followedByWhiteSpace_ &&
-          internal::GetMarker(marker) != TokenType::Text) {
-        markdown::trim(line, pos + count + 1);
-        Block node = std::make_shared<BlockNode>(internal::GetMarker(marker));
-        node->text_ = line;
-        return std::static_pointer_cast<NodeBase>(node);
+    int count = 0;
+    TokenType heading = HeadingType(line, pos, count);
+    if (heading != TokenType::Text) {
+      Block node = NewNode<BlockNode>(heading);
+      SetSource(*node, line.substr(pos));
+      markdown::trim(line, pos + count + 1);
+      node->text_ = line;
+      return std::static_pointer_cast<NodeBase>(node);
+    }
+
+    if constexpr (HasExtension(Ext, Extension::Tables)) {
+      if (IsTableStart(line)) {
+        blockType_ = BlockType::Table;
+        return BuildTableBlock(line);
       }
     }
 
@@ -56,55 +100,247 @@ Node Parser::BuildBlocks() {
       return BuildParagraphBlock();
     }
 
-    std::cout << std::quoted(line) << "\n";
+    diagnostics_.Report(DiagnosticCode::UnhandledLine, line.data());
   }
   return {};
 }
 
-Node Parser::BuildParagraphBlock() {
-  Block paragraph = std::make_shared<BlockNode>(TokenType::Paragraph);
+template <Extension Ext>
+TokenType BasicParser<Ext>::HeadingType(std::string_view line, size_t pos,
+                                        int& count) {
+  if (line[pos] != '#') {
+    return TokenType::Text;
+  }
+
+  Scanner scnr(line);
+  count = scnr.LookAhead(Scanner::CurPos::Begin, pos);
+  std::string_view marker(line.begin() + pos, count);
+  if (!scnr.followedByWhiteSpace_) {
+    return TokenType::Text;
+  }
+  return internal::GetMarker(marker);
+}
+
+template <Extension Ext>
+Node BasicParser<Ext>::BuildParagraphBlock() {
+  Block paragraph = NewNode<BlockNode>(TokenType::Paragraph);
   std::string_view line = scanner.CurrentLine();
-  std::string_view::iterator begin = line.begin();
-  size_t count = 0;
+  std::string_view::iterator begin = line.begin(), end = line.end();
 
   while (!line.empty() || !scanner.End()) {
     // paragraph ends
     size_t pos = line.find_first_not_of(' ');
     if (line.empty() || pos == std::string_view::npos) {
-      std::string_view text(begin, count);
-      internal::htrim(text);
-      paragraph->text_ = text;
-      return std::static_pointer_cast<NodeBase>(paragraph);
+      break;
+    }
+    // a table can interrupt a paragraph
+    if constexpr (HasExtension(Ext, Extension::Tables)) {
+      if (line.begin() != begin && IsTableStart(line)) {
+        scanner.UnscanLine();
+        break;
+      }
     }
 
-    count += line.size();
+    end = line.end();
     line = scanner.ScanNextLine();
   }
 
-  std::string_view text(begin, count);
+  std::string_view text(begin, std::distance(begin, end));
   internal::htrim(text);
   paragraph->text_ = text;
+  SetSource(*paragraph, text);
   return std::static_pointer_cast<NodeBase>(paragraph);
 }
 
-void Parser::AnalyzeBlocks(std::string_view doc) {
+// https://github.github.com/gfm/#tables-extension-
+// The header row is only a table if the next line is a delimiter row with the
+// same number of cells. On success the header cells are left in cells_ and the
+// column alignments in aligns_.
+template <Extension Ext>
+bool BasicParser<Ext>::IsTableStart(std::string_view line) {
+  if (line.find('|') == std::string_view::npos) {
+    return false;
+  }
+  if (!internal::ParseTableDelimiterRow(scanner.PeekNextLine(), cells_,
+                                        aligns_)) {
+    return false;
+  }
+
+  internal::SplitTableRow(line, cells_);
+  return cells_.size() == aligns_.size();
+}
+
+template <Extension Ext>
+Node BasicParser<Ext>::BuildTableBlock(std::string_view header) {
+  Block table = NewNode<BlockNode>(TokenType::Table);
+  table->children.push_back(BuildTableRow(TokenType::TableHead, header));
+  std::string_view last = scanner.ScanNextLine();  // delimiter row
+
+  std::string_view line;
+  while ((line = scanner.ScanNextLine()) != "" || !scanner.End()) {
+    // table ends at the first blank line or the beginning of another block
+    size_t pos = line.find_first_not_of(' ');
+    if (line.empty() || pos == std::string_view::npos) {
+      break;
+    }
+    int count = 0;
+    if (HeadingType(line, pos, count) != TokenType::Text) {
+      scanner.UnscanLine();
+      break;
+    }
+
+    internal::SplitTableRow(line, cells_);
+    table->children.push_back(BuildTableRow(TokenType::TableRow, line));
+    last = line;
+  }
+
+  SetSource(*table,
+            std::string_view(header.begin(),
+                             std::distance(header.begin(), last.end())));
+  return std::static_pointer_cast<NodeBase>(table);
+}
+
+// Builds a row out of cells_, padded with empty cells or truncated to the
+// number of columns of the table
+template <Extension Ext>
+Node BasicParser<Ext>::BuildTableRow(TokenType type, std::string_view line) {
+  Block row = NewNode<BlockNode>(type);
+  internal::htrim(line);
+  SetSource(*row, line);
+  row->children.reserve(aligns_.size());
+  for (size_t i = 0; i < aligns_.size(); i++) {
+    TableCell cell = NewNode<TableCellNode>(aligns_[i]);
+    if (i < cells_.size()) {
+      cell->text_ = cells_[i];
+      SetSource(*cell, cells_[i]);
+    } else {
+      SetSource(*cell, line.substr(line.size()));
+    }
+    row->children.push_back(std::static_pointer_cast<NodeBase>(cell));
+  }
+  return std::static_pointer_cast<NodeBase>(row);
+}
+
+template <Extension Ext>
+void BasicParser<Ext>::AnalyzeBlocks(std::string_view doc) {
   AssignDocument(doc);
   AnalyzeBlocks();
 }
-void Parser::AnalyzeBlocks() {
+template <Extension Ext>
+void BasicParser<Ext>::AnalyzeBlocks() {
+#ifdef PARSEMD_STATS
+  // the last line does not have to end in a newline
+  stats_.lines += std::count(document_.begin(), document_.end(), '\n') +
+                  (!document_.empty() && document_.back() != '\n');
+#endif
+  PARSEMD_STAT_TIMER(stats_, Blocks);
   scanner.Init(document_);
-  block_ = std::make_shared<BlockNode>(TokenType::Root);
+  nodes_ = 0;
+  block_ = NewNode<BlockNode>(TokenType::Root);
+  SetSource(*block_, document_);
 
   while (!scanner.End()) {
+    if (LimitReached()) {
+      break;
+    }
     blockType_ = BlockType::Root;
     Node child = BuildBlocks();
     if (child) {
+      HashBlocks(*child);
       block_->children.push_back(child);
     }
   }
+  SetHash(*block_);
+}
+
+template <Extension Ext>
+void BasicParser<Ext>::SetSource([[maybe_unused]] NodeBase& node,
+                                 [[maybe_unused]] std::string_view span) {
+#ifdef PARSEMD_SOURCE_POS
+  node.source_.begin = span.data() - document_.data();
+  node.source_.end = node.source_.begin + span.size();
+#endif
+}
+
+template <Extension Ext>
+void BasicParser<Ext>::SetHash([[maybe_unused]] NodeBase& node) {
+#ifdef PARSEMD_NODE_HASH
+  uint64_t hash = internal::NodeSeedHash(node);
+  if (const ContainerNode* cnode = ContainerNodePtr(&node)) {
+    for (const Node& child : cnode->children) {
+      hash = internal::HashCombine(hash, child->hash_);
+    }
+  }
+  node.hash_ = hash;
+#endif
+}
+
+template <Extension Ext>
+void BasicParser<Ext>::HashBlocks([[maybe_unused]] NodeBase& node) {
+#ifdef PARSEMD_NODE_HASH
+  for (const Node& child : ContainerNodePtr(&node)->children) {
+    HashBlocks(*child);
+  }
+  SetHash(node);
+#endif
+}
+
+template <Extension Ext>
+std::string_view BasicParser<Ext>::LimitInput(std::string_view doc) {
+  if (doc.size() <= limits_.maxInputSize) {
+    return doc;
+  }
+  doc = doc.substr(0, limits_.maxInputSize);
+  size_t newline = doc.rfind('\n');
+  return newline == std::string_view::npos ? doc : doc.substr(0, newline + 1);
+}
+
+// Keeps the first limit hit
+template <Extension Ext>
+void BasicParser<Ext>::Truncate(ParseLimits::Limit limit) {
+  if (truncated_ == ParseLimits::None) {
+    truncated_ = limit;
+  }
+}
+
+template <Extension Ext>
+bool BasicParser<Ext>::LimitReached() {
+  if (nodes_ >= limits_.maxNodes) {
+    Truncate(ParseLimits::Nodes);
+    return true;
+  }
+  if (limits_.cancel && limits_.cancel->load(std::memory_order_relaxed)) {
+    Truncate(ParseLimits::Cancelled);
+    return true;
+  }
+  if (limits_.deadline != ParseLimits::Clock::time_point::max() &&
+      ParseLimits::Clock::now() >= limits_.deadline) {
+    Truncate(ParseLimits::Deadline);
+    return true;
+  }
+  return false;
+}
+
+// make_shared from resource_ that keeps the node count and statistics
+template <Extension Ext>
+template <typename T, typename... Args>
+std::shared_ptr<T> BasicParser<Ext>::NewNode(Args&&... args) {
+  std::shared_ptr<T> node =
+      std::allocate_shared<T>(std::pmr::polymorphic_allocator<T>(resource_),
+                              std::forward<Args>(args)..., resource_);
+  nodes_++;
+  PARSEMD_STAT(stats_.nodes++);
+  // plus the shared_ptr control block
+  PARSEMD_STAT(stats_.bytesAllocated +=
+               sizeof(T) + 2 * sizeof(long) + sizeof(void*));
+  if constexpr (std::is_base_of_v<BlockNode, T>) {
+    PARSEMD_STAT(stats_.blocks++);
+  }
+  return node;
 }
 
-Node Parser::BuildInline(TokenList::iterator it) {
+template <Extension Ext>
+Node BasicParser<Ext>::BuildInline(TokenList::iterator it) {
   if (candTokens_.empty() || it == candTokens_.end())
     return {};
 
@@ -116,102 +352,211 @@ Node Parser::BuildInline(TokenList::iterator it) {
       count += it->second.size();
       ++it;
     }
-    Text b = std::make_shared<TextNode>(
-        TokenType::Text, std::string(begin->second.begin(), count));
+    Text b = NewNode<TextNode>(TokenType::Text,
+                               std::string_view(begin->second.begin(), count));
+    PARSEMD_STAT(stats_.bytesAllocated += count);
+    SetSource(*b, std::string_view(begin->second.begin(), count));
+    SetHash(*b);
     candTokens_.erase(begin, it);
     return b;
   }
 
-  Inline b = std::make_shared<InlineNode>(TokenType::None);
+  if (IsInlineOpen(type) && depth_ >= limits_.maxDepth) {
+    Truncate(ParseLimits::Depth);
+    FlattenInline(it);
+    return BuildInline(it);
+  }
+
+  Inline b = NewNode<InlineNode>(TokenType::None);
   if (type == TokenType::Softbreak) {
     b->type_ = TokenType::Softbreak;
+    SetSource(*b, it->second);
     candTokens_.erase(it);
   }
 
-  else if (type == TokenType::EmphOpen) {
-    b->type_ = TokenType::Emph;
-    while (std::next(it)->first != TokenType::EmphClose) {
+  // containers are laid out as Type, TypeOpen, TypeClose
+  else if (IsInlineOpen(type)) {
+    b->type_ = type + -1;
+    depth_++;
+    while (std::next(it)->first != type + 1) {
       b->children.push_back(BuildInline(std::next(it)));
     }
+    depth_--;
+    std::string_view close = std::next(it)->second;
+    SetSource(*b, std::string_view(it->second.begin(),
+                                   std::distance(it->second.begin(),
+                                                 close.end())));
     candTokens_.erase(it, std::next(std::next(it)));
   }
 
-  else if (type == TokenType::StrongOpen) {
-    b->type_ = TokenType::Strong;
-    while (std::next(it)->first != TokenType::StrongClose) {
-      b->children.push_back(BuildInline(std::next(it)));
+  SetHash(*b);
+  return b;
+}
+
+// Turns the container opened at it and everything in it, except line breaks,
+// into literal text
+template <Extension Ext>
+void BasicParser<Ext>::FlattenInline(TokenList::iterator it) {
+  size_t open = 0;
+  do {
+    if (IsInlineOpen(it->first)) {
+      open++;
+    } else if (IsInlineOpen(it->first + -1)) {
+      open--;
     }
-    candTokens_.erase(it, std::next(std::next(it)));
-  }
+    if (it->first != TokenType::Softbreak) {
+      it->first = TokenType::Text;
+    }
+    ++it;
+  } while (open);
+}
 
-  return b;
+// Block and its table rows and cells
+static size_t CountBlocks(const NodeBase* node) {
+  size_t count = 1;
+  for (const Node& child : ContainerNodePtr(node)->children) {
+    count += IsBlock(child->Type()) ? CountBlocks(child.get()) : 0;
+  }
+  return count;
 }
 
-void Parser::AnalyzeInline() {
+template <Extension Ext>
+void BasicParser<Ext>::AnalyzeInline() {
   if (block_->type_ == TokenType::None) {
     return;
   }
 
-  int count = 1;
-  for (Node& node : block_->children) {
-    if (node->type_ < TokenType::Root || node->type_ > TokenType::H6) {
+  // from here on nodes_ counts the nodes of the blocks parsed so far
+  nodes_ = 1;
+  Nodes& children = block_->children;
+  for (size_t i = 0; i < children.size(); i++) {
+    if (!IsBlock(children[i]->type_)) {
       continue;
     }
-    Block block = BlockNodePtr(node);
-
-    scanner.Init(block->text_);
-    while (!scanner.End()) {
-      char c = scanner.ScanNextByte();
-      if (c == '\n') {
-        PushCandToken();
-        scanner.Flush();
-        std::string_view lexeme = scanner.Scan(1, Scanner::CurPos::BeginIt);
-        candTokens_.emplace_back(TokenType::Softbreak, lexeme);
-        scanner.FlushBytes(1);
-      } else if (internal::IsDelimiter(c)) {
-        count = scanner.LookAhead(Scanner::CurPos::Cur, -1);
-        if (internal::IsValidDelimiter(
-                scanner.At(Scanner::CurPos::Cur, -2), c,
-                scanner.At(Scanner::CurPos::Cur, count - 1))) {
-          PushCandToken(count);
-        } else {
-          scanner.SkipNextBytes(count - 1);
+    if (LimitReached()) {
+      // blocks not reached are dropped, not left with raw text
+      children.resize(i);
+      break;
+    }
+    nodes_ += CountBlocks(children[i].get());
+    AnalyzeInline(BlockNodePtr(children[i]));
+  }
+  SetHash(*block_);
+}
+
+template <Extension Ext>
+template <bool Padded>
+void BasicParser<Ext>::ScanInline(std::string_view text) {
+  int count = 1;
+  char prev, next;
+  delimiters_ = 0;
+  scanner.Init(text);
+  while (!scanner.End()) {
+    char c = scanner.ScanNextByte();
+    if (c == '\n') {
+      PushCandToken();
+      scanner.Flush();
+      std::string_view lexeme = scanner.Scan(1, Scanner::CurPos::BeginIt);
+      candTokens_.emplace_back(TokenType::Softbreak, lexeme);
+      scanner.FlushBytes(1);
+      if (candTokens_.size() >= limits_.maxTokens) {
+        break;
+      }
+    } else if (internal::delimiterKind<Ext>[static_cast<unsigned char>(c)] >=
+               0) {
+      count = scanner.CurrentRun<Padded>(prev, next);
+      if (internal::IsValidDelimiter(prev, c, next)) {
+        PushDelimiterRun(count, prev, next);
+        if (candTokens_.size() >= limits_.maxTokens) {
+          break;
         }
+      } else {
+        scanner.SkipNextBytes(count - 1);
       }
     }
-    PushCandToken();
+  }
+  PushCandToken();
+  // stopped at maxTokens, the rest of the block is literal text
+  if (!scanner.End()) {
+    Truncate(ParseLimits::Tokens);
+    std::string_view rest(scanner.it_,
+                          std::distance(scanner.it_, scanner.data_.end()));
+    candTokens_.emplace_back(TokenType::Text, rest);
+  }
+}
 
-    // for (auto token : candTokens_) {
-    //   std::cout << token->first << "\t" << std::quoted(token->second)
-    //             << std::endl;
-    // }
-    // delimStack.debug();
-    delimStack.ProcessEmphasis(candTokens_);
-    // for (auto token : candTokens_) {
-    //   std::cout << token->first << "\t" << std::quoted(token->second)
-    //             << std::endl;
-    // }
-    // delimStack.debug();
-    delimStack.Clear();
-
-    while (!candTokens_.empty()) {
-      block->children.push_back(BuildInline(candTokens_.begin()));
+template <Extension Ext>
+void BasicParser<Ext>::AnalyzeInline(const Block& block) {
+  // every cell is an independent inline unit
+  if (IsTable(block->type_) && block->type_ != TokenType::TableCell) {
+    for (Node& node : block->children) {
+      AnalyzeInline(BlockNodePtr(node));
     }
-    block->text_ = {};
-    candTokens_ = {};
+    SetHash(*block);
+    return;
+  }
+
+  {
+    PARSEMD_STAT_TIMER(stats_, InlineScan);
+    std::string_view text = block->text_;
+    // the padded routines may read past the block, into the document
+    if (padded_ && text.data() >= document_.data() &&
+        text.data() + text.size() <= document_.data() + document_.size()) {
+      ScanInline<true>(text);
+    } else {
+      ScanInline<false>(text);
+    }
+  }
+  PARSEMD_STAT(stats_.tokens += candTokens_.size());
+  PARSEMD_STAT(stats_.bytesAllocated +=
+               candTokens_.size() * (sizeof(Token) + 2 * sizeof(void*)));
+
+  // for (auto token : candTokens_) {
+  //   std::cout << token->first << "\t" << std::quoted(token->second)
+  //             << std::endl;
+  // }
+  // delimStack.debug();
+  {
+    PARSEMD_STAT_TIMER(stats_, Emphasis);
+    delimStack.ProcessEmphasis(candTokens_);
   }
+  // for (auto token : candTokens_) {
+  //   std::cout << token->first << "\t" << std::quoted(token->second)
+  //             << std::endl;
+  // }
+  // delimStack.debug();
+  PARSEMD_STAT(stats_.openerSteps += delimStack.OpenerSteps());
+  delimStack.Clear();
+
+  PARSEMD_STAT_TIMER(stats_, TreeBuild);
+
+  while (!candTokens_.empty()) {
+    block->children.push_back(BuildInline(candTokens_.begin()));
+  }
+  block->text_ = {};
+  candTokens_ = {};
+  SetHash(*block);
 }
 
-void Parser::PushCandToken() {
+template <Extension Ext>
+void BasicParser<Ext>::PushCandToken() {
   std::string_view lexeme = scanner.CurrentLine();
   if (!lexeme.empty() && lexeme != "\n") {
     candTokens_.emplace_back(TokenType::Text, lexeme);
   }
 }
 
-void Parser::PushCandToken(size_t count) {
+template <Extension Ext>
+void BasicParser<Ext>::PushCandToken(size_t count) {
+  PushDelimiterRun(count, scanner.At(Scanner::CurPos::Cur, -2),
+                   scanner.At(Scanner::CurPos::Cur, count - 1));
+}
+
+// prev and next are the bytes around the run, as Scanner::At sees them
+template <Extension Ext>
+void BasicParser<Ext>::PushDelimiterRun(size_t count, char prev, char next) {
   std::string_view lexeme = scanner.CurrentLine();
-  if (!lexeme.empty()) {
+  if (lexeme.size() > 1) {
     lexeme.remove_suffix(1);
     candTokens_.emplace_back(TokenType::Text, lexeme);
   }
@@ -219,80 +564,51 @@ void Parser::PushCandToken(size_t count) {
 
   lexeme = scanner.Scan(count, Scanner::CurPos::BeginIt);
   if (lexeme.empty()) {
-    std::cerr << "WARNING: Trying to push empty token as a candidate token!"
-              << std::endl;
+    diagnostics_.Report(DiagnosticCode::EmptyDelimiterRun,
+                        scanner.CurrentLine().data());
     return;
   }
 
-  // NOTE: push after validation of char c
-  candTokens_.emplace_back(internal::GetMarker(lexeme), lexeme);
-  TokenList::iterator tokenPtr = std::prev(candTokens_.end());
   char c = scanner.CurrentByte();
-  char prev = scanner.At(Scanner::CurPos::Cur, -2);
-  char next = scanner.At(Scanner::CurPos::Cur, count - 1);
+  int kind = internal::delimiterKind<Ext>[static_cast<unsigned char>(c)];
+  const internal::DelimiterRule& rule = internal::delimiterRules[kind];
+
+  // https://spec.commonmark.org/0.31.2/#can-open-emphasis
+  bool left = internal::IsLeftFlanking(prev, next);
+  bool right = internal::IsRightFlanking(prev, next);
+  bool canOpen = left, canClose = right;
+  if (!rule.intraword) {
+    canOpen = left && (!right || internal::IsPunctuation(prev));
+    canClose = right && (!left || internal::IsPunctuation(next));
+  }
 
+  if ((canOpen || canClose) && delimiters_ >= limits_.maxDelimiters) {
+    Truncate(ParseLimits::Delimiters);
+    canOpen = canClose = false;
+  }
+
+  // runs that can neither open nor close are literal text
+  if ((!canOpen && !canClose) || (rule.maxRun && count > rule.maxRun)) {
+    candTokens_.emplace_back(TokenType::Text, lexeme);
+    scanner.FlushBytes(count);
+    return;
+  }
+
+  candTokens_.emplace_back(internal::GetMarker(lexeme), lexeme);
   DelimiterStack::DelimiterStackItem dsi = {
-      .delim = (c == '*') ? DelimiterStack::Delimiter::Asteriks
-                          : DelimiterStack::Delimiter::Underscore,
-      .number = count,
+      .kind = static_cast<unsigned char>(kind),
+      .type = (canOpen && canClose) ? DelimiterStack::DelimiterType::Both
+              : canOpen             ? DelimiterStack::DelimiterType::Open
+                                    : DelimiterStack::DelimiterType::Close,
       .isActive = true,
-      .type = DelimiterStack::DelimiterType::Open,
-      .tokenIt = tokenPtr,
+      .number = count,
+      .tokenIt = std::prev(candTokens_.end()),
   };
 
-  if (c == '*') {
-    int state = 0;
-    if (internal::IsLeftFlanking(prev, next)) {
-      state++;
-    }
-    if (internal::IsRightFlanking(prev, next)) {
-      state += 2;
-    }
-
-    switch (state) {
-      case 1:
-        dsi.type = DelimiterStack::DelimiterType::Open;
-        break;
-      case 2:
-        dsi.type = DelimiterStack::DelimiterType::Close;
-        break;
-      case 3:
-        dsi.type = DelimiterStack::DelimiterType::Both;
-        break;
-    }
-
-  } else if (c == '_') {
-    int state = 0;
-    if (internal::IsLeftFlanking(prev, next) &&
-        (!internal::IsRightFlanking(prev, next) ||
-         internal::IsPunctuation(prev))) {
-      state++;
-    }
-    if (internal::IsRightFlanking(prev, next) &&
-        (!internal::IsLeftFlanking(prev, next) ||
-         internal::IsPunctuation(next))) {
-      state += 2;
-    }
-
-    switch (state) {
-      case 1:
-        dsi.type = DelimiterStack::DelimiterType::Open;
-        break;
-      case 2:
-        dsi.type = DelimiterStack::DelimiterType::Close;
-        break;
-      case 3:
-        dsi.type = DelimiterStack::DelimiterType::Both;
-        break;
-    }
-
-  } else {
-    std::cerr << "Unhandled Delimiter " << std::quoted(std::to_string(c))
-              << std::endl;
-    std::exit(1);
-  }
-
   delimStack.Push(dsi);
+  delimiters_++;
+  PARSEMD_STAT(stats_.delimiterPushes++);
+  PARSEMD_STAT(stats_.bytesAllocated += sizeof(dsi) + 2 * sizeof(void*));
 
   scanner.FlushBytes(count);
 }
@@ -301,48 +617,157 @@ void Parser::PushCandToken(size_t count) {
 //   AssignDocument(doc);
 // }
 
-Node Parser::Parse() {
+template <Extension Ext>
+Node BasicParser<Ext>::Parse() {
   AnalyzeBlocks();
   AnalyzeInline();
   return GetBlock();
 }
-Node Parser::Parse(std::string_view doc) {
-  AnalyzeBlocks(doc);
-  AnalyzeInline();
+template <Extension Ext>
+Node BasicParser<Ext>::Parse(std::string_view doc) {
+  AssignDocument(doc);
   return Parse();
 }
 
-Node Parser::GetRoot() {
+template <Extension Ext>
+Node BasicParser<Ext>::Parse(const PaddedString& doc) {
+  BorrowDocument(doc);
+  return Parse();
+}
+
+template <Extension Ext>
+Node BasicParser<Ext>::GetRoot() {
   return GetBlock();
 }
 
-TokenList Parser::GetTokens() {
+template <Extension Ext>
+Node BasicParser<Ext>::NextBlock() {
+  while (!scanner.End() && !LimitReached()) {
+    blockType_ = BlockType::Root;
+    Node child = BuildBlocks();
+    if (!child) {
+      continue;
+    }
+    nodes_ += CountBlocks(child.get());
+    // the inline pass reuses the scanner
+    Scanner blocks = scanner;
+    AnalyzeInline(BlockNodePtr(child));
+    scanner = blocks;
+    return child;
+  }
+  return {};
+}
+
+template <Extension Ext>
+size_t BasicParser<Ext>::BlockOffset() const {
+  return std::distance(document_.begin(), scanner.it_);
+}
+
+template <Extension Ext>
+void BasicParser<Ext>::Reset() {
+  storage_.Clear();
+  BorrowDocument(std::string_view());
+  block_ = {};
+  candTokens_ = {};
+  delimStack.Clear();
+}
+
+template <Extension Ext>
+TokenList BasicParser<Ext>::GetTokens() {
   return candTokens_;
 }
 
-std::string Parser::DumpTree(const Node& node, int depth) {
-  std::stringstream ss;
-  ss << std::string(depth * 2, ' ') << node->type_;
-  if (IsText(node->type_)) {
-    ss << ' ' << std::quoted(TextNodePtr(node)->text);
-    ss << "\n";
-    return ss.str();
-  }
+template <Extension Ext>
+const ParseStats& BasicParser<Ext>::Stats() const {
+#ifdef PARSEMD_STATS
+  return stats_;
+#else
+  static const ParseStats empty;
+  return empty;
+#endif
+}
 
-  auto cnode = ContainerNodePtr(node);
-  if (IsBlock(node->type_) && node->type_ != TokenType::Root) {
-    auto bnode = BlockNodePtr(node);
-    if (!bnode->text_.empty()) {
-      ss << ' ' << std::quoted(bnode->text_);
-    }
+template <Extension Ext>
+void BasicParser<Ext>::ClearStats([[maybe_unused]] bool trace) {
+#ifdef PARSEMD_STATS
+  stats_.Clear();
+  stats_.trace = trace;
+#endif
+}
+
+template <Extension Ext>
+const Diagnostics& BasicParser<Ext>::GetDiagnostics() const {
+  return diagnostics_;
+}
+
+template <Extension Ext>
+void BasicParser<Ext>::SetDiagnosticHandler(DiagnosticHandler handler) {
+  diagnostics_.SetHandler(std::move(handler));
+}
+
+template <Extension Ext>
+void BasicParser<Ext>::SetLimits(const ParseLimits& limits) {
+  limits_ = limits;
+}
+
+template <Extension Ext>
+const ParseLimits& BasicParser<Ext>::Limits() const {
+  return limits_;
+}
+
+template <Extension Ext>
+ParseLimits::Limit BasicParser<Ext>::Truncated() const {
+  return truncated_;
+}
+
+// Appends sv as a std::quoted string would print it
+static void AppendQuoted(std::string& out, std::string_view sv) {
+  out += '"';
+  size_t pos;
+  while ((pos = sv.find_first_of("\"\\")) != std::string_view::npos) {
+    out.append(sv.data(), pos);
+    out += '\\';
+    out += sv[pos];
+    sv.remove_prefix(pos + 1);
   }
+  out.append(sv);
+  out += '"';
+}
 
-  ss << "\n";
-  for (auto child : cnode->children) {
-    ss << DumpTree(child, depth + 1);
+template <Extension Ext>
+std::string BasicParser<Ext>::DumpTree(const Node& node, int depth) {
+  std::string out;
+  if (node) {
+    DumpTree(*node, out, depth);
   }
+  return out;
+}
 
-  return ss.str();
+template <Extension Ext>
+void BasicParser<Ext>::DumpTree(const NodeBase& root,
+                                std::string& out,
+                                int depth) {
+  for (Cursor cursor(root, SIZE_MAX); cursor.Next();) {
+    if (cursor.GetEvent() != Cursor::Enter) {
+      continue;
+    }
+    const NodeBase* node = &cursor.Current();
+    out.append((depth + cursor.Depth()) * 2, ' ');
+    out.append(TokenStrView(node->type_));
+    if (const TextNode* text = TextNodePtr(node)) {
+      out += ' ';
+      AppendQuoted(out, text->text);
+    } else if (const BlockNode* bnode = BlockNodePtr(node);
+               bnode && node->type_ != TokenType::Root &&
+               !bnode->text_.empty()) {
+      out += ' ';
+      AppendQuoted(out, bnode->text_);
+    }
+    out += '\n';
+  }
 }
 
+template class BasicParser<dialect::CommonMark>;
+template class BasicParser<dialect::GFM>;
+
 }  // namespace markdown
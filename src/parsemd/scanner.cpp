@@ -1,6 +1,6 @@
-#include <iostream>
 #include <iterator>
 
+#include "parsemd/diagnostics.h"
 #include "parsemd/scanner.h"
 
 namespace markdown {
@@ -17,6 +17,10 @@ void Scanner::Init(std::string_view data) {
   begin_ = it_ = data_.begin();
 }
 
+void Scanner::SetDiagnostics(Diagnostics* diagnostics) {
+  diagnostics_ = diagnostics;
+}
+
 char Scanner::At(CurPos curPos, int offset) {
   std::string_view::iterator it = GetIterator(curPos);
   auto size = std::distance(data_.begin(), it) + offset;
@@ -77,6 +81,19 @@ std::string_view Scanner::CurrentLine() {
   return std::string_view(begin_, std::distance(begin_, it));
 }
 
+// Next line without the newline, internal state unaffected
+std::string_view Scanner::PeekNextLine() {
+  std::string_view::iterator it = it_;
+  while (it != data_.end() && *it != '\n')
+    ++it;
+  return std::string_view(it_, std::distance(it_, it));
+}
+
+// Puts back the line returned by the last ScanNextLine
+void Scanner::UnscanLine() {
+  it_ = begin_;
+}
+
 std::string_view Scanner::FlushCurrentLine() {
   std::string_view line = CurrentLine();
   Flush();
@@ -91,7 +108,11 @@ void Scanner::Flush() {
 
 void Scanner::FlushBytes(size_t n) {
   if (std::distance(data_.begin(), begin_) + n > data_.size()) {
-    std::cerr << "OVERFLOW while Flushing Bytes" << std::endl;
+    if (diagnostics_) {
+      diagnostics_->Report(
+          DiagnosticCode::ScannerOverflow,
+          data_.data() + std::distance(data_.begin(), begin_));
+    }
     begin_ = it_ = data_.end();
     return;
   }
@@ -118,13 +139,18 @@ int Scanner::LookAhead(CurPos curPos, int offset) {
   }
 
   it = it + offset;
+  // ValidArgs lets an offset land on the end, which has no run to count
+  if (it == data_.end()) {
+    followedByWhiteSpace_ = false;
+    return -1;
+  }
   char c = *it;
   int count = 1;
   while ((it + count) != data_.end() && *(it + count) == c) {
     count++;
   }
 
-  followedByWhiteSpace_ = (*(it + count) == ' ');
+  followedByWhiteSpace_ = (it + count) != data_.end() && *(it + count) == ' ';
   return count;
 }
 
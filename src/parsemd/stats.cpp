@@ -0,0 +1,74 @@
+#include <algorithm>
+#include <charconv>
+
+#include "parsemd/stats.h"
+
+namespace markdown {
+
+// Keeps trace and the capacity of events
+void ParseStats::Clear() {
+  std::fill(std::begin(stageNanos), std::end(stageNanos), 0);
+  lines = blocks = tokens = delimiterPushes = openerSteps = nodes = 0;
+  bytesAllocated = 0;
+  events.clear();
+}
+
+std::string_view ParseStats::StageName(Stage stage) {
+  switch (stage) {
+    case Blocks:
+      return "blocks";
+    case InlineScan:
+      return "inline scan";
+    case Emphasis:
+      return "emphasis";
+    case TreeBuild:
+      return "tree build";
+  }
+  return "";
+}
+
+static void AppendMicros(std::string& out, uint64_t nanos) {
+  char digits[24];
+  auto [end, ec] = std::to_chars(digits, digits + sizeof(digits), nanos / 1000);
+  out.append(digits, end - digits);
+  out += '.';
+  uint64_t fraction = nanos % 1000;
+  out += '0' + fraction / 100;
+  out += '0' + fraction / 10 % 10;
+  out += '0' + fraction % 10;
+}
+
+void ParseStats::WriteTrace(std::string& out) const {
+  out += "{\"traceEvents\":[";
+  for (size_t i = 0; i < events.size(); i++) {
+    const TraceEvent& event = events[i];
+    out += i ? ",\n" : "\n";
+    out += "{\"name\":\"";
+    out += StageName(event.stage);
+    out += "\",\"cat\":\"parsemd\",\"ph\":\"X\",\"pid\":1,\"tid\":1,\"ts\":";
+    AppendMicros(out, event.begin);
+    out += ",\"dur\":";
+    AppendMicros(out, event.duration);
+    out += '}';
+  }
+  out += "\n]}\n";
+}
+
+StageTimer::StageTimer(ParseStats& stats, ParseStats::Stage stage)
+    : stats_(stats), stage_(stage), begin_(std::chrono::steady_clock::now()) {}
+
+StageTimer::~StageTimer() {
+  auto end = std::chrono::steady_clock::now();
+  uint64_t duration =
+      std::chrono::duration_cast<std::chrono::nanoseconds>(end - begin_)
+          .count();
+  stats_.stageNanos[stage_] += duration;
+  if (stats_.trace) {
+    uint64_t begin = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                         begin_.time_since_epoch())
+                         .count();
+    stats_.events.push_back({stage_, begin, duration});
+  }
+}
+
+}  // namespace markdown
@@ -2,11 +2,7 @@
 
 namespace markdown {
 
-TokenType operator+(TokenType t, int i) {
-  return static_cast<TokenType>(static_cast<int>(t) + i);
-}
-
-const std::string TokenStr(const TokenType& token) {
+std::string_view TokenStrView(const TokenType& token) {
   switch (token) {
 #define X(TOKEN_NAME, TOKEN_VAL) \
   case TokenType::TOKEN_NAME:    \
@@ -17,8 +13,12 @@ const std::string TokenStr(const TokenType& token) {
   return "Token::None";
 }
 
+const std::string TokenStr(const TokenType& token) {
+  return std::string(TokenStrView(token));
+}
+
 std::ostream& operator<<(std::ostream& os, const TokenType& tt) {
-  return os << TokenStr(tt);
+  return os << TokenStrView(tt);
 }
 
 }  // namespace markdown
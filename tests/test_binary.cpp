@@ -0,0 +1,75 @@
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+#include "parsemd/binary.h"
+#include "parsemd/mappedfile.h"
+#include "parsemd/parser.h"
+
+using namespace markdown;
+
+// Same format as Parser::DumpTree
+static std::string DumpBinary(BinaryTree::NodeView node, int depth = 0) {
+  std::stringstream ss;
+  ss << std::string(depth * 2, ' ') << node.Type();
+  if (!node.Text().empty()) {
+    ss << ' ' << std::quoted(node.Text());
+  }
+  ss << "\n";
+  for (uint32_t i = 0; i < node.ChildCount(); i++) {
+    ss << DumpBinary(node.Child(i), depth + 1);
+  }
+  return ss.str();
+}
+
+TEST(BinaryAst, BinaryRoundTrip) {
+  Parser t;
+  Node root = t.Parse(
+      "# Title\n\nSome **strong** and *emph*\ntext\n\n| a | b |\n|:-:|--|\n"
+      "| ~~x~~ | y |");
+  std::string bytes = SerializeBinary(root);
+
+  BinaryTree tree(bytes);
+  ASSERT_TRUE(tree.Valid());
+  ASSERT_EQ(DumpBinary(tree.Root()), Parser::DumpTree(root));
+
+  BinaryTree::NodeView cell = tree.Root().Child(2).Child(0).Child(0);
+  ASSERT_EQ(cell.Type(), TokenType::TableCell);
+  ASSERT_EQ(cell.Align(), Alignment::Center);
+}
+
+TEST(BinaryAst, BinaryBlocksOnly) {
+  Parser t;
+  t.AnalyzeBlocks("Paragraph 1\n\n## Heading");
+  Node root = t.GetRoot();
+  std::string bytes = SerializeBinary(root);
+  BinaryTree tree(bytes);
+  ASSERT_TRUE(tree.Valid());
+  ASSERT_EQ(DumpBinary(tree.Root()), Parser::DumpTree(root));
+}
+
+TEST(BinaryAst, BinaryRejectsInvalid) {
+  Parser t;
+  std::string bytes = SerializeBinary(t.Parse("text"));
+
+  ASSERT_FALSE(BinaryTree(std::string_view()).Valid());
+  ASSERT_FALSE(BinaryTree(std::string_view(bytes).substr(0, 30)).Valid());
+  bytes[0] = 'X';
+  ASSERT_FALSE(BinaryTree(bytes).Valid());
+}
+
+TEST(BinaryAst, BinaryMappedFile) {
+  Parser t;
+  Node root = t.Parse("Mapped *file*");
+  std::string path = testing::TempDir() + "parsemd_binary_test.pmdb";
+  std::ofstream(path, std::ios::binary) << SerializeBinary(root);
+
+  MappedFile file(path);
+  ASSERT_TRUE(file.IsOpen());
+  BinaryTree tree(file.View());
+  ASSERT_TRUE(tree.Valid());
+  ASSERT_EQ(DumpBinary(tree.Root()), Parser::DumpTree(root));
+  std::remove(path.c_str());
+}
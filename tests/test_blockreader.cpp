@@ -0,0 +1,55 @@
+#include <gtest/gtest.h>
+
+#include "parsemd/blockreader.h"
+#include "parsemd/node.h"
+
+using namespace markdown;
+
+TEST(BlockReader, BlockReaderMatchesParse) {
+  std::string_view source =
+      "# Title\n\nSome *text*\nmore **text**\n\n| a | b |\n|---|:-:|\n| c | "
+      "~~d~~ |\n\n## End\n";
+  Parser t;
+  Node root = t.Parse(source);
+  const auto& children = ContainerNodePtr(root)->children;
+
+  BlockReader reader(source);
+  size_t i = 0;
+  for (const Node& block : reader) {
+    ASSERT_LT(i, children.size());
+    ASSERT_EQ(Parser::DumpTree(block), Parser::DumpTree(children[i]));
+    i++;
+  }
+  ASSERT_EQ(i, children.size());
+  ASSERT_EQ(reader.Offset(), source.size());
+  ASSERT_EQ(reader.Next(), nullptr);
+  ASSERT_EQ(reader.begin(), reader.end());
+}
+
+TEST(BlockReader, BlockReaderStopsEarly) {
+  std::string source = "# Title\n\nFirst *paragraph*\n\n";
+  size_t snippet = source.size();
+  for (int i = 0; i < 10000; i++) {
+    source += "Another paragraph with **strong** text\n\n";
+  }
+
+  BlockReader reader(source);
+  Node heading = reader.Next();
+  ASSERT_EQ(heading->Type(), TokenType::H1);
+  Node paragraph = reader.Next();
+  // clang-format off
+  ASSERT_EQ(
+    Parser::DumpTree(paragraph),
+R"(Token::Paragraph
+  Token::Text "First "
+  Token::Emph
+    Token::Text "paragraph"
+)");
+  // clang-format on
+  // nothing after the second block has been scanned
+  ASSERT_LE(reader.Offset(), snippet);
+
+  auto it = reader.begin();
+  ASSERT_EQ((*it)->Type(), TokenType::Paragraph);
+  ASSERT_GT(reader.Offset(), snippet);
+}
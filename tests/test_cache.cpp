@@ -0,0 +1,70 @@
+#include <gtest/gtest.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "parsemd/cache.h"
+#include "parsemd/node.h"
+#include "parsemd/parser.h"
+
+using namespace markdown;
+
+TEST(ParseCache, CacheHitMiss) {
+  ParseCache cache;
+  SharedDocument a = cache.Get("# Title\n\nSome **text**");
+  SharedDocument b = cache.Get("# Title\n\nSome **text**");
+  SharedDocument c = cache.Get("Other text");
+
+  ASSERT_EQ(a, b);
+  ASSERT_NE(a, c);
+  ASSERT_EQ(a->Source(), "# Title\n\nSome **text**");
+  ASSERT_EQ(ContainerNodePtr(&a->Root())->children.size(), 2);
+  ASSERT_EQ(cache.Find("missing"), nullptr);
+
+  ParseCache::Stats stats = cache.GetStats();
+  ASSERT_EQ(stats.hits, 1);
+  ASSERT_EQ(stats.misses, 3);
+  ASSERT_EQ(stats.entries, 2);
+}
+
+TEST(ParseCache, CacheEviction) {
+  // a single shard with room for about one document
+  SharedDocument doc = ParseCache().Get(std::string(1000, 'a'));
+  ParseCache cache(doc->Bytes() + doc->Bytes() / 2, 1);
+
+  SharedDocument first = cache.Get(std::string(1000, 'a'));
+  cache.Get(std::string(1000, 'b'));
+  ParseCache::Stats stats = cache.GetStats();
+  ASSERT_EQ(stats.evictions, 1);
+  ASSERT_EQ(stats.entries, 1);
+  ASSERT_EQ(cache.Find(std::string(1000, 'a')), nullptr);
+  // evicted documents stay alive for their holders
+  ASSERT_EQ(first->Source(), std::string(1000, 'a'));
+}
+
+TEST(ParseCache, CacheThreads) {
+  ParseCache cache(1 << 20, 4);
+  std::vector<std::string> docs;
+  for (int i = 0; i < 16; i++) {
+    docs.push_back("Document " + std::to_string(i) + " with *emph*");
+  }
+
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 8; t++) {
+    threads.emplace_back([&cache, &docs]() {
+      for (int round = 0; round < 50; round++) {
+        for (const std::string& doc : docs) {
+          SharedDocument parsed = cache.Get(doc);
+          ASSERT_EQ(parsed->Source(), doc);
+        }
+      }
+    });
+  }
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+
+  ParseCache::Stats stats = cache.GetStats();
+  ASSERT_EQ(stats.entries, docs.size());
+  ASSERT_EQ(stats.hits + stats.misses, 8 * 50 * docs.size());
+}
@@ -0,0 +1,106 @@
+#include <gtest/gtest.h>
+
+#include "parsemd/cursor.h"
+#include "parsemd/html.h"
+#include "parsemd/json.h"
+#include "parsemd/node.h"
+#include "parsemd/parser.h"
+
+using namespace markdown;
+
+// One line per event, "+" on enter and "-" on exit
+static std::string Events(Cursor& cursor) {
+  std::string out;
+  while (cursor.Next()) {
+    out.append(cursor.Depth() * 2, ' ');
+    out += cursor.GetEvent() == Cursor::Enter ? '+' : '-';
+    out += TokenStr(cursor.Current().Type());
+    out += '\n';
+  }
+  return out;
+}
+
+TEST(Cursor, CursorEvents) {
+  Parser t;
+  Node root = t.Parse("# Hi *there*\n\nText");
+  Cursor cursor(root);
+  std::string events = Events(cursor);
+  ASSERT_EQ(events,
+            "+Token::Root\n"
+            "  +Token::H1\n"
+            "    +Token::Text\n"
+            "    +Token::Emph\n"
+            "      +Token::Text\n"
+            "    -Token::Emph\n"
+            "  -Token::H1\n"
+            "  +Token::Paragraph\n"
+            "    +Token::Text\n"
+            "  -Token::Paragraph\n"
+            "-Token::Root\n");
+  ASSERT_FALSE(cursor.Next());
+  ASSERT_FALSE(cursor.Truncated());
+
+  // restarting keeps working
+  cursor.Reset(*root);
+  ASSERT_EQ(Events(cursor), events);
+}
+
+TEST(Cursor, CursorSkipChildren) {
+  Parser t;
+  Node root = t.Parse("# Hi *there*\n\nText");
+  std::string out;
+  for (Cursor cursor(root); cursor.Next();) {
+    if (cursor.Current().Type() == TokenType::H1) {
+      cursor.SkipChildren();
+    }
+    out += TokenStr(cursor.Current().Type()) + " ";
+  }
+  ASSERT_EQ(out,
+            "Token::Root Token::H1 Token::H1 Token::Paragraph Token::Text "
+            "Token::Paragraph Token::Root ");
+}
+
+TEST(Cursor, CursorMaxDepth) {
+  Parser t;
+  Node root = t.Parse("# Hi *there*");
+  Cursor cursor(root, 2);
+  ASSERT_EQ(Events(cursor),
+            "+Token::Root\n"
+            "  +Token::H1\n"
+            "    +Token::Text\n"
+            "    +Token::Emph\n"
+            "    -Token::Emph\n"
+            "  -Token::H1\n"
+            "-Token::Root\n");
+  ASSERT_TRUE(cursor.Truncated());
+}
+
+TEST(Cursor, CursorEmpty) {
+  Cursor empty;
+  ASSERT_FALSE(empty.Next());
+  ASSERT_FALSE(Cursor(Node()).Next());
+
+  TextNode text(TokenType::Text, "leaf");
+  Cursor cursor(text);
+  ASSERT_TRUE(cursor.Next());
+  ASSERT_EQ(&cursor.Current(), &text);
+  ASSERT_FALSE(cursor.Next());
+}
+
+TEST(Cursor, WritersWalkPastDefaultDepth) {
+  // nodes holds every level, so the tree is freed without recursing
+  std::vector<Node> nodes = {std::make_shared<BlockNode>(TokenType::Root)};
+  size_t depth = Cursor::defaultMaxDepth + 10;
+  for (size_t i = 1; i < depth; i++) {
+    Node node = std::make_shared<InlineNode>(TokenType::Emph);
+    ContainerNodePtr(nodes.back())->children.push_back(node);
+    nodes.push_back(node);
+  }
+  ContainerNodePtr(nodes.back())
+      ->children.push_back(std::make_shared<TextNode>(TokenType::Text, "x"));
+
+  std::string json = ToJson(nodes[0]);
+  ASSERT_NE(json.find("\"x\""), std::string::npos);
+  std::string html = ToHtml(nodes[0]);
+  ASSERT_EQ(html.size(), (depth - 1) * 9 + 1);
+}
@@ -0,0 +1,57 @@
+#include <gtest/gtest.h>
+
+#include "parsemd/diagnostics.h"
+#include "parsemd/parser.h"
+#include "parsemd/scanner.h"
+
+using namespace markdown;
+
+TEST(Diagnostics, DiagnosticsScannerOverflow) {
+  std::string_view input = "abc";
+  Diagnostics diagnostics;
+  diagnostics.Begin(input);
+  Scanner scanner(input);
+  scanner.SetDiagnostics(&diagnostics);
+
+  scanner.FlushBytes(2);
+  ASSERT_TRUE(diagnostics.Empty());
+  scanner.FlushBytes(5);
+  ASSERT_TRUE(scanner.End());
+  ASSERT_EQ(diagnostics.Records().size(), 1);
+  ASSERT_EQ(diagnostics.Records()[0].code, DiagnosticCode::ScannerOverflow);
+  ASSERT_EQ(diagnostics.Records()[0].offset, 2);
+}
+
+TEST(Diagnostics, DiagnosticsCapacity) {
+  std::string_view input = "abc";
+  Diagnostics diagnostics(2);
+  diagnostics.Begin(input);
+  size_t handled = 0;
+  diagnostics.SetHandler([&handled](const Diagnostic&) { handled++; });
+
+  for (int i = 0; i < 5; i++) {
+    diagnostics.Report(DiagnosticCode::UnhandledLine, input.data() + 1);
+  }
+  diagnostics.Report(DiagnosticCode::UnhandledLine, "elsewhere");
+  ASSERT_EQ(diagnostics.Records().size(), 2);
+  ASSERT_EQ(diagnostics.Records()[1].offset, 1);
+  ASSERT_EQ(diagnostics.Dropped(), 4);
+  ASSERT_EQ(handled, 6);
+
+  // a new document starts over, the handler stays
+  diagnostics.Begin(input);
+  ASSERT_TRUE(diagnostics.Empty());
+  diagnostics.Report(DiagnosticCode::EmptyDelimiterRun, "elsewhere");
+  ASSERT_EQ(diagnostics.Records()[0].offset, Diagnostic::noOffset);
+  ASSERT_EQ(handled, 7);
+}
+
+TEST(Diagnostics, DiagnosticsCleanParse) {
+  Parser t;
+  size_t handled = 0;
+  t.SetDiagnosticHandler([&handled](const Diagnostic&) { handled++; });
+  t.Parse("# Title\n\n*a* **b** ~~c~~ *\n\n| x |\n|---|\n| y |\n");
+  ASSERT_TRUE(t.GetDiagnostics().Empty());
+  ASSERT_EQ(handled, 0);
+  ASSERT_FALSE(DiagnosticMessage(DiagnosticCode::ScannerOverflow).empty());
+}
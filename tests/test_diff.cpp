@@ -0,0 +1,80 @@
+#include <gtest/gtest.h>
+
+#include "parsemd/diff.h"
+#include "parsemd/document.h"
+#include "parsemd/node.h"
+#include "parsemd/parser.h"
+
+using namespace markdown;
+
+static std::vector<BlockChange> Diff(std::string_view before,
+                                     std::string_view after) {
+  Parser t;
+  Node oldRoot = t.Parse(before);
+  Node newRoot = t.Parse(after);
+  return DiffBlocks(*oldRoot, *newRoot);
+}
+
+static bool operator==(const BlockChange& a, const BlockChange& b) {
+  return a.oldBegin == b.oldBegin && a.oldEnd == b.oldEnd &&
+         a.newBegin == b.newBegin && a.newEnd == b.newEnd;
+}
+
+TEST(Diff, DiffStructuralHash) {
+  Parser t;
+  Node a = t.Parse("# Title\n\nSome *text*\n\n| a |\n|:-:|\n| b |");
+  Node b = t.Parse("# Title\n\nSome *text*\n\n| a |\n|:-:|\n| b |");
+  Node c = t.Parse("# Title\n\nSome **text**\n\n| a |\n|--:|\n| b |");
+  const Nodes& as = ContainerNodePtr(a)->children;
+  const Nodes& cs = ContainerNodePtr(c)->children;
+  ASSERT_EQ(StructuralHash(*a), StructuralHash(*b));
+  ASSERT_NE(StructuralHash(*a), StructuralHash(*c));
+  ASSERT_EQ(StructuralHash(*as[0]), StructuralHash(*cs[0]));
+  // emphasis and alignment are part of the structure
+  ASSERT_NE(StructuralHash(*as[1]), StructuralHash(*cs[1]));
+  ASSERT_NE(StructuralHash(*as[2]), StructuralHash(*cs[2]));
+#ifdef PARSEMD_NODE_HASH
+  ASSERT_EQ(a->Hash(), b->Hash());
+  ASSERT_NE(as[1]->Hash(), 0);
+#else
+  ASSERT_EQ(a->Hash(), 0);
+#endif
+}
+
+TEST(Diff, DiffBlocks) {
+  ASSERT_TRUE(Diff("a\n\nb\n\nc", "a\n\nb\n\nc").empty());
+
+  auto changes = Diff("a\n\nb\n\nc\n\nd", "a\n\nB\n\nc\n\nd\n\ne");
+  ASSERT_EQ(changes.size(), 2);
+  ASSERT_TRUE((changes[0] == BlockChange{1, 2, 1, 2}));
+  ASSERT_TRUE((changes[1] == BlockChange{4, 4, 4, 5}));
+
+  // a block moved down: one removal, one insertion
+  changes = Diff("x\n\na\n\nb\n\nc", "a\n\nb\n\nx\n\nc");
+  ASSERT_EQ(changes.size(), 2);
+  ASSERT_TRUE((changes[0] == BlockChange{0, 1, 0, 0}));
+  ASSERT_TRUE((changes[1] == BlockChange{3, 3, 2, 3}));
+
+  changes = Diff("a\n\nb", "");
+  ASSERT_EQ(changes.size(), 1);
+  ASSERT_TRUE((changes[0] == BlockChange{0, 2, 0, 0}));
+}
+
+TEST(Diff, DiffBlocksMaxEdits) {
+  Parser t;
+  Node oldRoot = t.Parse("a\n\nb\n\nc\n\nd\n\ne");
+  Node newRoot = t.Parse("a\n\n1\n\nc\n\n2\n\ne");
+  ASSERT_EQ(DiffBlocks(*oldRoot, *newRoot).size(), 2);
+  auto changes = DiffBlocks(*oldRoot, *newRoot, 2);
+  ASSERT_EQ(changes.size(), 1);
+  ASSERT_TRUE((changes[0] == BlockChange{1, 4, 1, 4}));
+}
+
+TEST(Diff, DiffLazyRoot) {
+  std::string_view source = "# a\n\n*b*\n\nc";
+  LazyDocument lazy = ParseLazy(source);
+  Parser t;
+  Node root = t.Parse(source);
+  ASSERT_EQ(StructuralHash(lazy.Root()), StructuralHash(*root));
+  ASSERT_TRUE(DiffBlocks(lazy.Root(), *root).empty());
+}
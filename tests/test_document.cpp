@@ -0,0 +1,111 @@
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <fstream>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+#include "parsemd/document.h"
+#include "parsemd/node.h"
+#include "parsemd/parser.h"
+
+using namespace markdown;
+
+TEST(Document, ParseFileMapped) {
+  std::string source = "# Title\n\nSome **text**\n";
+  std::string path = testing::TempDir() + "parsemd_document_test.md";
+  std::ofstream(path, std::ios::binary) << source;
+
+  Document doc = ParseFile(path);
+  std::remove(path.c_str());
+
+  // the mapping outlives the file name
+  ASSERT_EQ(doc.Source(), source);
+  const ContainerNode* root = ContainerNodePtr(&doc.Root());
+  ASSERT_EQ(root->children.size(), 2);
+  ASSERT_EQ(root->children[0]->Type(), TokenType::H1);
+
+  Parser t;
+  ASSERT_EQ(Parser::DumpTree(ContainerNodePtr(&doc.Root())->children[1]),
+            Parser::DumpTree(ContainerNodePtr(t.Parse(source))->children[1]));
+}
+
+TEST(Document, ParseFileEmpty) {
+  std::string path = testing::TempDir() + "parsemd_document_empty.md";
+  std::ofstream(path, std::ios::binary).flush();
+
+  Document doc = ParseFile(path);
+  std::remove(path.c_str());
+  ASSERT_EQ(doc.Source(), "");
+  ASSERT_EQ(ContainerNodePtr(&doc.Root())->children.size(), 0);
+}
+
+TEST(Document, ParseFileCommonMark) {
+  std::string source = "~~a~~ | b\n|-|\n";
+  std::string path = testing::TempDir() + "parsemd_document_cm.md";
+  std::ofstream(path, std::ios::binary) << source;
+
+  Document doc = ParseFile<dialect::CommonMark>(path);
+  std::remove(path.c_str());
+  CommonMarkParser t;
+  ASSERT_EQ(Parser::DumpTree(ContainerNodePtr(&doc.Root())->children[0]),
+            Parser::DumpTree(ContainerNodePtr(t.Parse(source))->children[0]));
+  ASSERT_EQ(ContainerNodePtr(&doc.Root())->children[0]->Type(),
+            TokenType::Paragraph);
+}
+
+TEST(Document, ParseCountsSource) {
+  std::string source;
+  for (int i = 0; i < 1000; i++) {
+    source += "Some **strong** text\n\n";
+  }
+  Parser t;
+  // the same tree without a source
+  size_t nodeBytes = Document(t.Parse(source), {}, nullptr).Bytes();
+  ASSERT_GE(Parse(source).Bytes(), source.size() + nodeBytes);
+}
+
+TEST(Document, ParseFileMissing) {
+  ASSERT_THROW(ParseFile("/nonexistent/parsemd.md"), std::system_error);
+}
+
+static std::string DumpChildren(const NodeBase& root) {
+  std::string dump;
+  for (const Node& child : ContainerNodePtr(&root)->children) {
+    dump += Parser::DumpTree(child);
+  }
+  return dump;
+}
+
+TEST(Document, ParseReentrant) {
+  std::string source = "# Title\n\n| a | b |\n|---|---|\n| *1* | ~~2~~ |\n";
+  Parser t;
+  std::string expected = DumpChildren(*t.Parse(source));
+
+  Document doc = Parse(source);
+  ASSERT_EQ(doc.Source(), source);
+  ASSERT_EQ(DumpChildren(doc.Root()), expected);
+
+  std::vector<std::thread> threads;
+  std::vector<std::string> dumps(8);
+  for (size_t i = 0; i < dumps.size(); i++) {
+    threads.emplace_back([&source, &dumps, i]() {
+      for (int round = 0; round < 100; round++) {
+        dumps[i] = DumpChildren(Parse(source).Root());
+      }
+    });
+  }
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+  for (const std::string& dump : dumps) {
+    ASSERT_EQ(dump, expected);
+  }
+}
+
+TEST(Document, ParseDialect) {
+  Document doc = Parse<dialect::CommonMark>("~~text~~");
+  const ContainerNode* paragraph =
+      ContainerNodePtr(ContainerNodePtr(&doc.Root())->children[0].get());
+  ASSERT_EQ(paragraph->children[0]->Type(), TokenType::Text);
+}
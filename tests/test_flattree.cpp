@@ -0,0 +1,94 @@
+#include <gtest/gtest.h>
+#include <iomanip>
+#include <sstream>
+
+#include "parsemd/flattree.h"
+#include "parsemd/node.h"
+#include "parsemd/parser.h"
+
+using namespace markdown;
+
+// Same format as Parser::DumpTree, from a linear sweep
+static std::string DumpFlat(const FlatTree& tree) {
+  std::stringstream ss;
+  for (uint32_t i = 0; i < tree.Size(); i++) {
+    ss << std::string(tree[i].depth * 2, ' ') << tree.Type(i);
+    if (!tree.Text(i).empty()) {
+      ss << ' ' << std::quoted(tree.Text(i));
+    }
+    ss << "\n";
+  }
+  return ss.str();
+}
+
+TEST(FlatTree, FlatMatchesTree) {
+  Parser t;
+  Node root = t.Parse(
+      "# Title\n\nSome **strong** and *emph*\ntext\n\n| a | b |\n|:-:|--|\n"
+      "| ~~x~~ | y |");
+  FlatTree tree(root);
+  ASSERT_EQ(DumpFlat(tree), Parser::DumpTree(root));
+  ASSERT_EQ(tree[0].end, tree.Size());
+  ASSERT_TRUE(tree.Types().empty());
+
+  t.AnalyzeBlocks("Paragraph 1\n\n## Heading");
+  tree.Build(*t.GetRoot());
+  ASSERT_EQ(DumpFlat(tree), Parser::DumpTree(t.GetRoot()));
+}
+
+TEST(FlatTree, FlatNavigation) {
+  Parser t;
+  FlatTree tree(t.Parse("# A *b*\n\n| x |\n|--:|\n| y |"));
+
+  // Root > H1, Table
+  uint32_t h1 = tree.FirstChild(0);
+  ASSERT_EQ(tree.Type(h1), TokenType::H1);
+  uint32_t table = tree.NextSibling(h1);
+  ASSERT_EQ(tree.Type(table), TokenType::Table);
+  ASSERT_EQ(tree.NextSibling(table), FlatTree::npos);
+
+  // H1 > Text, Emph > Text
+  uint32_t text = tree.FirstChild(h1);
+  ASSERT_EQ(tree.Text(text), "A ");
+  ASSERT_EQ(tree.FirstChild(text), FlatTree::npos);
+  uint32_t emph = tree.NextSibling(text);
+  ASSERT_EQ(tree.Type(emph), TokenType::Emph);
+  ASSERT_EQ(tree.Text(tree.FirstChild(emph)), "b");
+  ASSERT_EQ(tree.NextSibling(emph), FlatTree::npos);
+
+  uint32_t cell = tree.FirstChild(tree.FirstChild(table));
+  ASSERT_EQ(tree.Type(cell), TokenType::TableCell);
+  ASSERT_EQ(tree.Align(cell), Alignment::Right);
+}
+
+TEST(FlatTree, FlatTypeColumn) {
+  Parser t;
+  FlatTree tree(t.Parse("# A\n\ntext\n\n## B"), true);
+  ASSERT_EQ(tree.Types().size(), tree.Size());
+  size_t headings = 0;
+  for (uint8_t type : tree.Types()) {
+    headings += IsHeading(static_cast<TokenType>(type));
+  }
+  ASSERT_EQ(headings, 2);
+}
+
+TEST(FlatTree, FlatMaxDepth) {
+  Parser t;
+  FlatTree shallow(t.Parse("*a*"));
+  ASSERT_FALSE(shallow.Truncated());
+
+  // nodes holds every level, so the tree is freed without recursing
+  std::vector<Node> nodes = {std::make_shared<BlockNode>(TokenType::Root)};
+  for (size_t i = 0; i < FlatTree::maxDepth + 10; i++) {
+    Node node = std::make_shared<InlineNode>(TokenType::Emph);
+    ContainerNodePtr(nodes.back())->children.push_back(node);
+    nodes.push_back(node);
+  }
+  FlatTree tree(nodes[0]);
+  ASSERT_TRUE(tree.Truncated());
+  ASSERT_EQ(tree.Size(), FlatTree::maxDepth + 1);
+  ASSERT_EQ(tree[tree.Size() - 1].depth, FlatTree::maxDepth);
+
+  tree.Clear();
+  ASSERT_FALSE(tree.Truncated());
+}
@@ -0,0 +1,81 @@
+#include <gtest/gtest.h>
+
+#include "parsemd/html.h"
+#include "parsemd/node.h"
+#include "parsemd/parser.h"
+
+using namespace markdown;
+
+TEST(Html, HtmlBlocks) {
+  Parser t;
+  ASSERT_EQ(ToHtml(t.Parse("# Hi *there*\n\nSome **strong**\n~~text~~")),
+            "<h1>Hi <em>there</em></h1>\n"
+            "<p>Some <strong>strong</strong>\n<del>text</del></p>\n");
+}
+
+TEST(Html, HtmlTable) {
+  Parser t;
+  ASSERT_EQ(ToHtml(t.Parse("| a | b |\n|:-|--:|\n| c | d |")),
+            "<table>\n<thead>\n<tr>\n"
+            "<th align=\"left\">a</th>\n<th align=\"right\">b</th>\n"
+            "</tr>\n</thead>\n<tbody>\n<tr>\n"
+            "<td align=\"left\">c</td>\n<td align=\"right\">d</td>\n"
+            "</tr>\n</tbody>\n</table>\n");
+  // no body rows, no tbody
+  ASSERT_EQ(ToHtml(t.Parse("| a |\n|---|")),
+            "<table>\n<thead>\n<tr>\n<th>a</th>\n</tr>\n</thead>\n</table>\n");
+}
+
+TEST(Html, HtmlEscaping) {
+  Parser t;
+  ASSERT_EQ(ToHtml(t.Parse("<a href=\"x\">&amp;</a> \xc3\xa9")),
+            "<p>&lt;a href=&quot;x&quot;&gt;&amp;amp;&lt;/a&gt; "
+            "\xc3\xa9</p>\n");
+}
+
+TEST(Html, HtmlChunkedSink) {
+  Parser t;
+  Node root = t.Parse("# Title\n\nSome **strong** and *emph*\ntext\n");
+  std::string whole = ToHtml(root);
+
+  std::string chunked;
+  size_t chunks = 0;
+  HtmlWriter writer(
+      [&](std::string_view chunk) {
+        chunked.append(chunk);
+        chunks++;
+      },
+      8);
+  writer.Write(root);
+  ASSERT_EQ(chunked, whole);
+  ASSERT_GT(chunks, 1);
+}
+
+TEST(Html, HtmlParallelMatchesSequential) {
+  std::vector<std::string> inputs = {
+      "",
+      "one block",
+      "# a\n\nb *c*\nd\n\n| x | y |\n|:-:|---|\n| 1 | **2** |\n\n"
+      "## e\n\n~~f~~",
+  };
+  std::string& many = inputs.emplace_back();
+  for (int i = 0; i < 200; i++) {
+    many += "## Heading " + std::to_string(i) + "\n\nSome *text* & more\n" +
+            "lines **here**\n\n| a |\n|--:|\n| <" + std::to_string(i) +
+            "> |\n\n";
+  }
+  Parser t;
+  for (const std::string& input : inputs) {
+    Node root = t.Parse(input);
+    std::string expected = ToHtml(root);
+    for (size_t threads : {1, 2, 3, 8}) {
+      SCOPED_TRACE(threads);
+      std::string out;
+      ToHtmlParallel(*root, out, threads);
+      ASSERT_EQ(out, expected);
+    }
+  }
+  Node root = t.Parse(inputs.back());
+  ASSERT_EQ(ToHtmlChunks(*root, 4).size(), 16);
+  ASSERT_EQ(ToHtmlChunks(*root, 1).size(), 1);
+}
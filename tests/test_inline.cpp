@@ -42,3 +42,55 @@ R"(Token::Root
 )");
   // clang-format on
 }
+
+TEST(InlineAnalysis, InlineTestIntrawordU) {
+  Parser t;
+  t.Parse("snake_case_name and *emph*");
+  Node root = t.GetRoot();
+  // clang-format off
+  ASSERT_EQ(
+    Parser::DumpTree(root),
+R"(Token::Root
+  Token::Paragraph
+    Token::Text "snake_case_name and "
+    Token::Emph
+      Token::Text "emph"
+)");
+  // clang-format on
+}
+
+TEST(InlineAnalysis, InlineTestStrikethrough) {
+  Parser t;
+  t.Parse("~~gone~~ and ~**bold**~ but ~~not~ ~~~this~~~");
+  Node root = t.GetRoot();
+  // clang-format off
+  ASSERT_EQ(
+    Parser::DumpTree(root),
+R"(Token::Root
+  Token::Paragraph
+    Token::Strikethrough
+      Token::Text "gone"
+    Token::Text " and "
+    Token::Strikethrough
+      Token::Strong
+        Token::Text "bold"
+    Token::Text " but ~~not~ ~~~this~~~"
+)");
+  // clang-format on
+}
+
+TEST(InlineAnalysis, InlineTestStrikethroughCommonMark) {
+  CommonMarkParser t;
+  t.Parse("~~gone~~ and *emph*");
+  Node root = t.GetRoot();
+  // clang-format off
+  ASSERT_EQ(
+    CommonMarkParser::DumpTree(root),
+R"(Token::Root
+  Token::Paragraph
+    Token::Text "~~gone~~ and "
+    Token::Emph
+      Token::Text "emph"
+)");
+  // clang-format on
+}
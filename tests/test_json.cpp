@@ -0,0 +1,65 @@
+#include <gtest/gtest.h>
+
+#include "parsemd/json.h"
+#include "parsemd/node.h"
+#include "parsemd/parser.h"
+
+using namespace markdown;
+
+#ifndef PARSEMD_SOURCE_POS
+TEST(Json, JsonTree) {
+  Parser t;
+  ASSERT_EQ(ToJson(t.Parse("# Hi *there*\n\n| a |\n|--:|\n| ~~b~~ |")),
+            R"({"type":"Root","children":[)"
+            R"({"type":"H1","children":[{"type":"Text","text":"Hi "},)"
+            R"({"type":"Emph","children":[{"type":"Text","text":"there"}]}]},)"
+            R"({"type":"Table","children":[)"
+            R"({"type":"TableHead","children":[{"type":"TableCell",)"
+            R"("align":"right","children":[{"type":"Text","text":"a"}]}]},)"
+            R"({"type":"TableRow","children":[{"type":"TableCell",)"
+            R"("align":"right","children":[{"type":"Strikethrough",)"
+            R"("children":[{"type":"Text","text":"b"}]}]}]}]}]})");
+}
+
+TEST(Json, JsonBlocksOnly) {
+  Parser t;
+  t.AnalyzeBlocks("Para\n\n## Heading");
+  ASSERT_EQ(ToJson(t.GetRoot()),
+            R"({"type":"Root","children":[)"
+            R"({"type":"Paragraph","text":"Para","children":[]},)"
+            R"({"type":"H2","text":"Heading","children":[]}]})");
+}
+#endif
+
+TEST(Json, JsonEscaping) {
+  Parser t;
+  std::string json = ToJson(t.Parse("say \"hi\\\" \x01 \xc3\xa9\tx"));
+  ASSERT_NE(json.find(R"("text":"say \"hi\\\" \u0001 )"
+                      "\xc3\xa9"
+                      R"(\tx")"),
+            std::string::npos)
+      << json;
+}
+
+TEST(Json, JsonChunkedSink) {
+  Parser t;
+  Node root = t.Parse("# Title\n\nSome **strong** and *emph*\ntext\n");
+  std::string whole = ToJson(root);
+
+  std::string chunked;
+  size_t chunks = 0;
+  JsonWriter writer(
+      [&](std::string_view chunk) {
+        chunked.append(chunk);
+        chunks++;
+      },
+      8);
+  writer.Write(root);
+  ASSERT_EQ(chunked, whole);
+  ASSERT_GT(chunks, 1);
+
+  // the writer is reusable
+  chunked.clear();
+  writer.Write(root);
+  ASSERT_EQ(chunked, whole);
+}
@@ -0,0 +1,87 @@
+#include <gtest/gtest.h>
+#include <thread>
+#include <vector>
+
+#include "parsemd/document.h"
+#include "parsemd/node.h"
+#include "parsemd/parser.h"
+
+using namespace markdown;
+
+static const std::string source =
+    "# Title *one*\n\nSome **strong** and *emph*\ntext\n\n| a | b |\n"
+    "|:-:|--|\n| ~~x~~ | y |\n\n## Two";
+
+TEST(LazyDocument, LazyBlocksOnly) {
+  LazyDocument doc = ParseLazy(source);
+  ASSERT_EQ(doc.Size(), 4);
+
+  Parser t;
+  t.AnalyzeBlocks(source);
+  std::string blocks;
+  Parser::DumpTree(doc.Blocks(), blocks);
+  ASSERT_EQ(blocks, Parser::DumpTree(t.GetRoot()));
+
+  // an outline never needs inline parsing
+  const ContainerNode* root = ContainerNodePtr(&doc.Blocks());
+  ASSERT_EQ(root->children[3]->Type(), TokenType::H2);
+  ASSERT_EQ(BlockNodePtr(root->children[3].get())->RawText(), "Two");
+}
+
+TEST(LazyDocument, LazyMatchesParse) {
+  LazyDocument doc = ParseLazy(source);
+  Parser t;
+  Node expected = t.Parse(source);
+
+  // one block, then the rest through Root
+  const ContainerNode* full = ContainerNodePtr(expected.get());
+  std::string dump;
+  Parser::DumpTree(doc.At(2), dump);
+  ASSERT_EQ(dump, Parser::DumpTree(full->children[2]));
+
+  dump.clear();
+  Parser::DumpTree(doc.Root(), dump);
+  ASSERT_EQ(dump, Parser::DumpTree(expected));
+  ASSERT_EQ(ContainerNodePtr(&doc.Root())->children[2].get(), &doc.At(2));
+
+  // the block structure is left as it was
+  ASSERT_EQ(BlockNodePtr(&doc.Blocks())->children[0]->Type(), TokenType::H1);
+  ASSERT_EQ(
+      BlockNodePtr(ContainerNodePtr(&doc.Blocks())->children[0].get())
+          ->RawText(),
+      "Title *one*");
+}
+
+TEST(LazyDocument, LazyDialect) {
+  LazyDocument doc = ParseLazy<dialect::CommonMark>("~~text~~");
+  ASSERT_EQ(ContainerNodePtr(&doc.At(0))->children[0]->Type(),
+            TokenType::Text);
+}
+
+TEST(LazyDocument, LazyConcurrentAccess) {
+  std::string big;
+  for (int i = 0; i < 200; i++) {
+    big += "Paragraph *" + std::to_string(i) + "* with **text**\n\n";
+  }
+  LazyDocument doc = ParseLazy(big);
+  Parser t;
+  std::string expected = Parser::DumpTree(t.Parse(big));
+
+  std::vector<std::string> dumps(4);
+  std::vector<std::thread> threads;
+  for (size_t n = 0; n < dumps.size(); n++) {
+    threads.emplace_back([&, n] {
+      // walk the blocks in different orders so threads race for them
+      for (size_t i = 0; i < doc.Size(); i++) {
+        doc.At(n % 2 ? doc.Size() - 1 - i : i);
+      }
+      Parser::DumpTree(doc.Root(), dumps[n]);
+    });
+  }
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+  for (const std::string& dump : dumps) {
+    ASSERT_EQ(dump, expected);
+  }
+}
@@ -0,0 +1,163 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+
+#include "parsemd/cursor.h"
+#include "parsemd/node.h"
+#include "parsemd/parser.h"
+
+using namespace markdown;
+
+TEST(ParseLimits, LimitDepth) {
+  Parser t;
+  ParseLimits limits;
+  limits.maxDepth = 1;
+  t.SetLimits(limits);
+  Node root = t.Parse("a *b **c** d* e");
+  ASSERT_EQ(t.Truncated(), ParseLimits::Depth);
+  // clang-format off
+  ASSERT_EQ(
+    Parser::DumpTree(root),
+R"(Token::Root
+  Token::Paragraph
+    Token::Text "a "
+    Token::Emph
+      Token::Text "b "
+      Token::Text "**c** d"
+    Token::Text " e"
+)");
+  // clang-format on
+
+  t.SetLimits({});
+  t.Parse("a *b **c** d* e");
+  ASSERT_EQ(t.Truncated(), ParseLimits::None);
+}
+
+TEST(ParseLimits, LimitDepthDefault) {
+  // each pair of runs nests 75000 containers, more than the stack holds
+  std::string deep = std::string(150000, '*') + "a" + std::string(150000, '*');
+  for (int dialect = 0; dialect < 2; dialect++) {
+    Parser gfm;
+    CommonMarkParser commonMark;
+    Node root = dialect ? commonMark.Parse(deep) : gfm.Parse(deep);
+    ASSERT_EQ(dialect ? commonMark.Truncated() : gfm.Truncated(),
+              ParseLimits::Depth);
+
+    size_t depth = 0;
+    for (Cursor cursor(root, SIZE_MAX); cursor.Next();) {
+      depth = std::max(depth, cursor.Depth());
+    }
+    // plus Root and Paragraph
+    ASSERT_EQ(depth, ParseLimits::defaultMaxDepth + 2);
+  }
+}
+
+TEST(ParseLimits, LimitTokens) {
+  Parser t;
+  ParseLimits limits;
+  limits.maxTokens = 3;
+  t.SetLimits(limits);
+  Node root = t.Parse("*a* *b* *c*\n\nx *y*");
+  ASSERT_EQ(t.Truncated(), ParseLimits::Tokens);
+  // clang-format off
+  ASSERT_EQ(
+    Parser::DumpTree(root),
+R"(Token::Root
+  Token::Paragraph
+    Token::Emph
+      Token::Text "a"
+    Token::Text " *b* *c*"
+  Token::Paragraph
+    Token::Text "x "
+    Token::Emph
+      Token::Text "y"
+)");
+  // clang-format on
+}
+
+TEST(ParseLimits, LimitDelimiters) {
+  Parser t;
+  ParseLimits limits;
+  limits.maxDelimiters = 2;
+  t.SetLimits(limits);
+  Node root = t.Parse("*a* *b* *c*");
+  ASSERT_EQ(t.Truncated(), ParseLimits::Delimiters);
+  // clang-format off
+  ASSERT_EQ(
+    Parser::DumpTree(root),
+R"(Token::Root
+  Token::Paragraph
+    Token::Emph
+      Token::Text "a"
+    Token::Text " *b* *c*"
+)");
+  // clang-format on
+}
+
+TEST(ParseLimits, LimitNodes) {
+  Parser t;
+  ParseLimits limits;
+  limits.maxNodes = 5;
+  t.SetLimits(limits);
+  Node root = t.Parse("a\n\nb *c*\n\nd\n\ne");
+  ASSERT_EQ(t.Truncated(), ParseLimits::Nodes);
+  // the block that crossed the limit is complete, later ones are dropped
+  // clang-format off
+  ASSERT_EQ(
+    Parser::DumpTree(root),
+R"(Token::Root
+  Token::Paragraph
+    Token::Text "a"
+  Token::Paragraph
+    Token::Text "b "
+    Token::Emph
+      Token::Text "c"
+)");
+  // clang-format on
+}
+
+TEST(ParseLimits, LimitInputSize) {
+  Parser t;
+  ParseLimits limits;
+  limits.maxInputSize = 8;
+  t.SetLimits(limits);
+  Node root = t.Parse("# a\nb\nccccc");
+  ASSERT_EQ(t.Truncated(), ParseLimits::InputSize);
+  // cut after the last line break within the limit
+  // clang-format off
+  ASSERT_EQ(
+    Parser::DumpTree(root),
+R"(Token::Root
+  Token::H1
+    Token::Text "a"
+  Token::Paragraph
+    Token::Text "b"
+)");
+  // clang-format on
+
+  t.BorrowDocument("abcdefghijk");
+  t.Parse();
+  ASSERT_EQ(t.Truncated(), ParseLimits::InputSize);
+}
+
+TEST(ParseLimits, LimitDeadlineAndCancel) {
+  Parser t;
+  ParseLimits limits;
+  limits.deadline = ParseLimits::Clock::now() - std::chrono::seconds(1);
+  t.SetLimits(limits);
+  Node root = t.Parse("a\n\nb");
+  ASSERT_EQ(t.Truncated(), ParseLimits::Deadline);
+  ASSERT_EQ(Parser::DumpTree(root), "Token::Root\n");
+
+  std::atomic<bool> cancel = false;
+  limits = {};
+  limits.cancel = &cancel;
+  t.SetLimits(limits);
+  t.Parse("a\n\nb");
+  ASSERT_EQ(t.Truncated(), ParseLimits::None);
+  cancel = true;
+  root = t.Parse("a\n\nb");
+  ASSERT_EQ(t.Truncated(), ParseLimits::Cancelled);
+  ASSERT_EQ(ContainerNodePtr(root)->children.size(), 0);
+  ASSERT_EQ(ParseLimits::LimitName(ParseLimits::Cancelled), "cancelled");
+}
@@ -0,0 +1,116 @@
+#include <gtest/gtest.h>
+
+#include <cstdlib>
+#include <new>
+
+#include "parsemd/node.h"
+#include "parsemd/parser.h"
+
+using namespace markdown;
+
+// Heap allocations of this thread while counting, to check that a parser with
+// a memory resource does not fall back to the global heap anywhere
+static thread_local bool countHeap = false;
+static thread_local size_t heapAllocations = 0;
+
+void* operator new(size_t size) {
+  if (countHeap) {
+    heapAllocations++;
+  }
+  if (void* p = std::malloc(size ? size : 1)) {
+    return p;
+  }
+  throw std::bad_alloc();
+}
+// also replaced, or it would come from a sanitizer's allocator and be freed by
+// the delete below
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+  if (countHeap) {
+    heapAllocations++;
+  }
+  return std::malloc(size ? size : 1);
+}
+void operator delete(void* p) noexcept {
+  std::free(p);
+}
+void operator delete(void* p, size_t) noexcept {
+  std::free(p);
+}
+
+// Forwards to upstream and counts what is still allocated
+class CountingResource : public std::pmr::memory_resource {
+ public:
+  size_t allocations = 0;
+  size_t live = 0;
+
+ protected:
+  void* do_allocate(size_t bytes, size_t align) override {
+    allocations++;
+    live += bytes;
+    return std::pmr::new_delete_resource()->allocate(bytes, align);
+  }
+  void do_deallocate(void* p, size_t bytes, size_t align) override {
+    live -= bytes;
+    std::pmr::new_delete_resource()->deallocate(p, bytes, align);
+  }
+  bool do_is_equal(const memory_resource& other) const noexcept override {
+    return this == &other;
+  }
+};
+
+static const char* document =
+    "# Title *emph*\n\n"
+    "A paragraph with **strong**, ~~struck~~ and *nested **runs***\n"
+    "over two lines.\n\n"
+    "| a | b |\n|:-|-:|\n| c | *d* |\n";
+
+TEST(Memory, MemoryEverythingFromResource) {
+  // no upstream: anything past the stack buffer throws
+  alignas(std::max_align_t) char buffer[64 << 10];
+  std::pmr::monotonic_buffer_resource resource(
+      buffer, sizeof(buffer), std::pmr::null_memory_resource());
+  Parser parser(&resource);
+  ASSERT_EQ(parser.Resource(), &resource);
+
+  countHeap = true;
+  heapAllocations = 0;
+  Node root = parser.Parse(document);
+  countHeap = false;
+  ASSERT_EQ(heapAllocations, 0);
+
+  Parser reference;
+  ASSERT_EQ(Parser::DumpTree(root), Parser::DumpTree(reference.Parse(document)));
+  ASSERT_EQ(ContainerNodePtr(root)->children.get_allocator().resource(),
+            &resource);
+}
+
+TEST(Memory, MemoryReleasedWithTree) {
+  CountingResource resource;
+  {
+    Parser parser(&resource);
+    Node root = parser.Parse(document);
+    ASSERT_GT(resource.allocations, 0);
+    parser.Reset();
+    size_t scratch = resource.live;
+    root = nullptr;
+    // the tree went back, the parser keeps its scratch for the next parse
+    ASSERT_LT(resource.live, scratch);
+    ASSERT_GT(resource.live, 0);
+  }
+  ASSERT_EQ(resource.live, 0);
+}
+
+TEST(Memory, MemoryPaddedStringResource) {
+  CountingResource resource;
+  {
+    PaddedString str("abc", &resource);
+    ASSERT_EQ(resource.allocations, 1);
+    PaddedString moved = std::move(str);
+    moved.Assign("a longer string than before");
+    ASSERT_EQ(resource.allocations, 2);
+    PaddedString copy = moved;
+    ASSERT_EQ(resource.allocations, 2);
+    ASSERT_EQ(copy.View(), moved.View());
+  }
+  ASSERT_EQ(resource.live, 0);
+}
@@ -0,0 +1,51 @@
+#include <gtest/gtest.h>
+
+#include "parsemd/padded.h"
+#include "parsemd/parser.h"
+
+using namespace markdown;
+
+TEST(Padded, PaddedStringPadding) {
+  PaddedString str("abc");
+  ASSERT_EQ(str.View(), "abc");
+  ASSERT_EQ(str.data()[-1], '\0');
+  for (size_t i = 0; i < PaddedString::padding; i++) {
+    ASSERT_EQ(str.data()[3 + i], '\0');
+  }
+
+  // shorter strings reuse the buffer and are padded again
+  const char* data = str.data();
+  str.Assign("x");
+  ASSERT_EQ(str.data(), data);
+  ASSERT_EQ(str.data()[1], '\0');
+  ASSERT_EQ(str.data()[2], '\0');
+
+  PaddedString moved = std::move(str);
+  ASSERT_EQ(moved.View(), "x");
+  ASSERT_TRUE(str.empty());
+  ASSERT_EQ(str.data()[0], '\0');
+}
+
+TEST(Padded, PaddedParseMatchesUnpadded) {
+  const char* inputs[] = {
+      "*a*",
+      "a*b*",
+      "**a** *",
+      "*",
+      "a ~~b~~ ~c~ ~~~d~~~",
+      "_a_b_ __c__\nd _e\n_f_",
+      "# *heading*\n\n***a** b*",
+      "| *a* | b* |\n|---|---|\n| **c | d** |",
+      "text ending in a run **",
+  };
+  Parser padded, unpadded;
+  for (const char* input : inputs) {
+    SCOPED_TRACE(input);
+    PaddedString doc(input);
+    std::string expected = Parser::DumpTree(padded.Parse(doc));
+    unpadded.BorrowDocument(std::string_view(input));
+    ASSERT_EQ(Parser::DumpTree(unpadded.Parse()), expected);
+    // Parse copies into its own padded buffer
+    ASSERT_EQ(Parser::DumpTree(unpadded.Parse(input)), expected);
+  }
+}
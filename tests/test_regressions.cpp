@@ -0,0 +1,74 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+
+#include "parsemd/parser.h"
+#include "parsemd/scanner.h"
+
+using namespace markdown;
+
+// Parsing an input repeated four times more often takes about four times as
+// long when the parse is linear and sixteen times when it is quadratic. A
+// ratio does not depend on the speed of the build, e.g. with sanitizers. Both
+// sides repeat the input, so that they have the same seams between copies.
+constexpr size_t baseCopies = 2;
+constexpr size_t growth = 4;
+constexpr double maxTimeRatio = 8;
+
+template <class P>
+static double BestNanos(P& parser, std::string_view input) {
+  double best = 1e300;
+  for (int i = 0; i < 5; i++) {
+    auto begin = std::chrono::steady_clock::now();
+    parser.Parse(input);
+    auto end = std::chrono::steady_clock::now();
+    best = std::min(
+        best, std::chrono::duration<double, std::nano>(end - begin).count());
+  }
+  return best;
+}
+
+static std::string Repeat(const std::string& input, size_t copies) {
+  std::string out;
+  for (size_t i = 0; i < copies; i++) {
+    out += input;
+  }
+  return out;
+}
+
+template <class P>
+static double TimeRatio(P& parser, const std::string& input) {
+  std::string base = Repeat(input, baseCopies);
+  std::string grown = Repeat(input, baseCopies * growth);
+  return BestNanos(parser, grown) / BestNanos(parser, base);
+}
+
+TEST(Regressions, RegressionsParseInLinearTime) {
+  Parser gfm;
+  CommonMarkParser commonMark;
+  size_t inputs = 0;
+  for (const auto& entry :
+       std::filesystem::directory_iterator(PARSEMD_REGRESSIONS_DIR)) {
+    std::ifstream file(entry.path(), std::ios::binary);
+    std::string input(std::istreambuf_iterator<char>(file), {});
+    SCOPED_TRACE(entry.path().filename().string());
+    ASSERT_FALSE(input.empty());
+    EXPECT_LT(TimeRatio(gfm, input), maxTimeRatio);
+    EXPECT_LT(TimeRatio(commonMark, input), maxTimeRatio);
+    inputs++;
+  }
+  ASSERT_GT(inputs, 0);
+}
+
+TEST(Regressions, LookAheadAtEnd) {
+  Scanner scanner("**");
+  ASSERT_EQ(scanner.LookAhead(Scanner::CurPos::Begin, 0), 2);
+  ASSERT_EQ(scanner.LookAhead(Scanner::CurPos::Begin, 1), 1);
+  // used to read the byte past the input
+  ASSERT_EQ(scanner.LookAhead(Scanner::CurPos::Begin, 2), -1);
+  ASSERT_EQ(scanner.LookAhead(Scanner::CurPos::End, 0), -1);
+}
@@ -0,0 +1,50 @@
+#include <gtest/gtest.h>
+#include "parsemd/lineindex.h"
+#include "parsemd/node.h"
+#include "parsemd/parser.h"
+
+using namespace markdown;
+
+TEST(SourcePosition, LineIndexLocate) {
+  LineIndex index("ab\n\ncd\n");
+  ASSERT_EQ(index.Lines(), 4);
+  ASSERT_EQ(index.Locate(0).line, 1);
+  ASSERT_EQ(index.Locate(1).column, 2);
+  ASSERT_EQ(index.Locate(3).line, 2);
+  ASSERT_EQ(index.Locate(5).line, 3);
+  ASSERT_EQ(index.Locate(5).column, 2);
+  ASSERT_EQ(index.LineBegin(3), 4);
+}
+
+#ifdef PARSEMD_SOURCE_POS
+static std::string Span(std::string_view doc, const Node& node) {
+  SourceRange range = node->Source();
+  return std::string(doc.substr(range.begin, range.end - range.begin));
+}
+
+TEST(SourcePosition, SourcePosBlocks) {
+  std::string doc = "# Title\n\nsome *emph*\ntext\n\n| a |\n| - |\n| b |\n";
+  Parser t;
+  Node root = t.Parse(doc);
+  Container container = ContainerNodePtr(root);
+  ASSERT_EQ(Span(doc, root), doc);
+  ASSERT_EQ(Span(doc, container->children[0]), "# Title");
+  ASSERT_EQ(Span(doc, container->children[1]), "some *emph*\ntext");
+  ASSERT_EQ(Span(doc, container->children[2]), "| a |\n| - |\n| b |");
+
+  Container paragraph = ContainerNodePtr(container->children[1]);
+  ASSERT_EQ(Span(doc, paragraph->children[0]), "some ");
+  ASSERT_EQ(Span(doc, paragraph->children[1]), "*emph*");
+}
+
+TEST(SourcePosition, SourcePosDelimiterRuns) {
+  std::string doc = "***a** b*";
+  Parser t;
+  Node root = t.Parse(doc);
+  Container emph = ContainerNodePtr(ContainerNodePtr(root)->children[0]);
+  emph = ContainerNodePtr(emph->children[0]);
+  ASSERT_EQ(emph->Type(), TokenType::Emph);
+  ASSERT_EQ(Span(doc, emph), "***a** b*");
+  ASSERT_EQ(Span(doc, emph->children[0]), "**a**");
+}
+#endif
@@ -0,0 +1,139 @@
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <fstream>
+#include <memory>
+
+#include "parsemd/flattree.h"
+#include "parsemd/html.h"
+#include "parsemd/parser.h"
+#include "parsemd/static.h"
+
+using namespace markdown;
+
+static constexpr char usage[] =
+    "# Usage *now*\n"
+    "Run it with **care**\n"
+    "and ~~haste~~\n\n"
+    "| a | b |\n"
+    "|:-|-:|\n"
+    "| c | *d* |\n";
+static constexpr auto html = PARSEMD_STATIC_HTML(usage);
+static_assert(html.View() ==
+              "<h1>Usage <em>now</em></h1>\n"
+              "<p>Run it with <strong>care</strong>\n"
+              "and <del>haste</del></p>\n"
+              "<table>\n<thead>\n<tr>\n"
+              "<th align=\"left\">a</th>\n<th align=\"right\">b</th>\n"
+              "</tr>\n</thead>\n<tbody>\n<tr>\n"
+              "<td align=\"left\">c</td>\n"
+              "<td align=\"right\"><em>d</em></td>\n"
+              "</tr>\n</tbody>\n</table>\n");
+
+static constexpr auto tree = PARSEMD_STATIC_TREE("Some **strong** text");
+static_assert(tree.size() == 6);
+static_assert(tree.Type(1) == TokenType::Paragraph);
+static_assert(tree.Type(3) == TokenType::Strong);
+static_assert(tree.Text(4) == "strong");
+static_assert(tree.NextSibling(3) == 5);
+
+// Nodes as FlatTree lays them out, from the sink of a runtime StaticParser
+struct FlatSink {
+  std::vector<FlatNode> nodes;
+  std::vector<std::string_view> texts;
+  std::vector<uint32_t> open;
+
+  void Open(TokenType type, Alignment align) {
+    open.push_back(nodes.size());
+    nodes.push_back({0, 0, 0, static_cast<uint16_t>(open.size() - 1),
+                     static_cast<uint8_t>(type), static_cast<uint8_t>(align)});
+    texts.emplace_back();
+  }
+  void Close(TokenType) {
+    nodes[open.back()].end = nodes.size();
+    open.pop_back();
+  }
+  void Text(std::string_view text) {
+    nodes.push_back({0, 0, static_cast<uint32_t>(nodes.size() + 1),
+                     static_cast<uint16_t>(open.size()),
+                     static_cast<uint8_t>(TokenType::Text), 0});
+    texts.push_back(text);
+  }
+};
+
+template <Extension Ext, size_t Capacity>
+static void ExpectSameTree(std::string_view input) {
+  ASSERT_LE(input.size(), Capacity);
+  auto parser = std::make_unique<internal::StaticParser<Ext, Capacity>>();
+  FlatSink sink;
+  parser->Parse(input, sink);
+
+  BasicParser<Ext> reference;
+  FlatTree flat(reference.Parse(input));
+  ASSERT_EQ(sink.nodes.size(), flat.Size());
+  for (uint32_t i = 0; i < flat.Size(); i++) {
+    SCOPED_TRACE(i);
+    ASSERT_EQ(sink.nodes[i].type, flat[i].type);
+    ASSERT_EQ(sink.nodes[i].align, flat[i].align);
+    ASSERT_EQ(sink.nodes[i].depth, flat[i].depth);
+    ASSERT_EQ(sink.nodes[i].end, flat[i].end);
+    ASSERT_EQ(sink.texts[i], flat.Text(i));
+  }
+}
+
+TEST(Static, StaticMatchesParser) {
+  const char* inputs[] = {
+      "",
+      "\n\n   \n",
+      "# ",
+      "####### seven\n#no space\n  ## indented ##  ",
+      "*a **b** c*\n_a __b__ c_ x_y_z\n***strong emph***",
+      "__*_\n**_*.",
+      "*foo**bar**baz*\n**foo*bar*baz**\n*a*** b ***c*",
+      "~a~ ~~b~~ ~~~c~~~ ~~d~",
+      "para\n| a | b |\n|---|---|\n| 1 | 2 | 3 |\n|4|\n# after",
+      "| a \\| b |\n|:-:|\n\n| x |\n| - |\nno delimiter row",
+      "<&\"> and *<em>*",
+  };
+  for (const char* input : inputs) {
+    SCOPED_TRACE(input);
+    ExpectSameTree<dialect::GFM, 256>(input);
+    ExpectSameTree<dialect::CommonMark, 256>(input);
+  }
+}
+
+TEST(Static, StaticMatchesParserRegressions) {
+  size_t inputs = 0;
+  for (const auto& entry :
+       std::filesystem::directory_iterator(PARSEMD_REGRESSIONS_DIR)) {
+    std::ifstream file(entry.path(), std::ios::binary);
+    std::string input(std::istreambuf_iterator<char>(file), {});
+    SCOPED_TRACE(entry.path().filename().string());
+    ExpectSameTree<dialect::GFM, 32 << 10>(input);
+    inputs++;
+  }
+  ASSERT_GT(inputs, 0);
+}
+
+TEST(Static, StaticMatchesParserDepthLimit) {
+  size_t runs = 2 * ParseLimits::defaultMaxDepth + 10;
+  std::string deep = "x " + std::string(runs, '*') + "a\nb" +
+                     std::string(runs, '*') + " _c_ " + std::string(runs, '_');
+  Parser parser;
+  parser.Parse(deep);
+  ASSERT_EQ(parser.Truncated(), ParseLimits::Depth);
+  ExpectSameTree<dialect::GFM, 8 << 10>(deep);
+  ExpectSameTree<dialect::CommonMark, 8 << 10>(deep);
+}
+
+TEST(Static, StaticHtmlMatchesToHtml) {
+  constexpr auto commonMark =
+      ToStaticHtml<StaticHtmlSize<dialect::CommonMark>("~~a~~ | *b*\n|-|"),
+                   dialect::CommonMark>("~~a~~ | *b*\n|-|");
+  CommonMarkParser parser;
+  ASSERT_EQ(commonMark.View(), ToHtml(parser.Parse("~~a~~ | *b*\n|-|")));
+
+  Parser gfm;
+  ASSERT_EQ(html.View(), ToHtml(gfm.Parse(usage)));
+  ASSERT_EQ(std::string_view(html.c_str()), html.View());
+}
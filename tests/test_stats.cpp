@@ -0,0 +1,51 @@
+#include <gtest/gtest.h>
+
+#include "parsemd/parser.h"
+#include "parsemd/stats.h"
+
+using namespace markdown;
+
+TEST(ParseStats, StatsTraceJson) {
+  ParseStats stats;
+  stats.events.push_back({ParseStats::InlineScan, 1500, 2000250});
+  std::string out;
+  stats.WriteTrace(out);
+  ASSERT_EQ(out,
+            "{\"traceEvents\":[\n"
+            "{\"name\":\"inline scan\",\"cat\":\"parsemd\",\"ph\":\"X\","
+            "\"pid\":1,\"tid\":1,\"ts\":1.500,\"dur\":2000.250}\n]}\n");
+}
+
+#ifdef PARSEMD_STATS
+TEST(ParseStats, StatsCounts) {
+  Parser t;
+  // a single parse, Parse(doc) used to run both passes twice
+  t.Parse("# Title\n\n*a* **b** *c\ntext\n\n| x |\n|---|\n| y |");
+  const ParseStats& stats = t.Stats();
+  ASSERT_EQ(stats.lines, 8);
+  // root, heading, paragraph, table, 2 rows, 2 cells
+  ASSERT_EQ(stats.blocks, 8);
+  // *, *, **, ** and the unmatched *
+  ASSERT_EQ(stats.delimiterPushes, 5);
+  ASSERT_GT(stats.openerSteps, 0);
+  ASSERT_GT(stats.tokens, 0);
+  ASSERT_GT(stats.nodes, stats.blocks);
+  ASSERT_GT(stats.bytesAllocated, 0);
+  ASSERT_TRUE(stats.events.empty());
+
+  t.ClearStats(true);
+  ASSERT_EQ(t.Stats().nodes, 0);
+  t.Parse("Some *text*");
+  // one block scanned, one inline unit through every inline stage
+  ASSERT_EQ(t.Stats().events.size(), 4);
+  ASSERT_EQ(t.Stats().events[0].stage, ParseStats::Blocks);
+  ASSERT_EQ(t.Stats().events[3].stage, ParseStats::TreeBuild);
+}
+#else
+TEST(ParseStats, StatsCompiledOut) {
+  Parser t;
+  t.Parse("# Title\n\ntext");
+  ASSERT_EQ(t.Stats().nodes, 0);
+  ASSERT_EQ(t.Stats().stageNanos[ParseStats::Blocks], 0);
+}
+#endif
@@ -0,0 +1,101 @@
+#include <gtest/gtest.h>
+#include "parsemd/node.h"
+#include "parsemd/parser.h"
+
+using namespace markdown;
+
+TEST(TableAnalysis, TableTestSimple) {
+  Parser t;
+  t.AnalyzeBlocks("| a | b |\n|---|---|\n| 1 | 2 |\n| 3 | 4 |");
+  Node root = t.GetRoot();
+  // clang-format off
+  ASSERT_EQ(
+    Parser::DumpTree(root),
+R"(Token::Root
+  Token::Table
+    Token::TableHead
+      Token::TableCell "a"
+      Token::TableCell "b"
+    Token::TableRow
+      Token::TableCell "1"
+      Token::TableCell "2"
+    Token::TableRow
+      Token::TableCell "3"
+      Token::TableCell "4"
+)");
+  // clang-format on
+}
+
+TEST(TableAnalysis, TableTestInline) {
+  Parser t;
+  t.Parse("Some text\na | **b**\n:-- | --:\n*x* | y \\| z\n\nAfter");
+  Node root = t.GetRoot();
+  // clang-format off
+  ASSERT_EQ(
+    Parser::DumpTree(root),
+R"(Token::Root
+  Token::Paragraph
+    Token::Text "Some text"
+  Token::Table
+    Token::TableHead
+      Token::TableCell
+        Token::Text "a"
+      Token::TableCell
+        Token::Strong
+          Token::Text "b"
+    Token::TableRow
+      Token::TableCell
+        Token::Emph
+          Token::Text "x"
+      Token::TableCell
+        Token::Text "y \\| z"
+  Token::Paragraph
+    Token::Text "After"
+)");
+  // clang-format on
+}
+
+TEST(TableAnalysis, TableTestRowWidth) {
+  Parser t;
+  t.AnalyzeBlocks("| a | b |\n| :-: | - |\n| 1 |\n| 2 | 3 | 4 |\n# Heading");
+  Node root = t.GetRoot();
+  // clang-format off
+  ASSERT_EQ(
+    Parser::DumpTree(root),
+R"(Token::Root
+  Token::Table
+    Token::TableHead
+      Token::TableCell "a"
+      Token::TableCell "b"
+    Token::TableRow
+      Token::TableCell "1"
+      Token::TableCell
+    Token::TableRow
+      Token::TableCell "2"
+      Token::TableCell "3"
+  Token::H1 "Heading"
+)");
+  // clang-format on
+
+  Node table = ContainerNodePtr(root)->children[0];
+  Node head = ContainerNodePtr(table)->children[0];
+  ASSERT_EQ(TableCellNodePtr(ContainerNodePtr(head)->children[0])->align,
+            Alignment::Center);
+  ASSERT_EQ(TableCellNodePtr(ContainerNodePtr(head)->children[1])->align,
+            Alignment::None);
+}
+
+TEST(TableAnalysis, TableTestNotATable) {
+  Parser t;
+  t.AnalyzeBlocks("| a | b |\n| --- |\n| 1 | 2 |");
+  Node root = t.GetRoot();
+  // clang-format off
+  ASSERT_EQ(
+    Parser::DumpTree(root),
+R"(Token::Root
+  Token::Paragraph "| a | b |
+| --- |
+| 1 | 2 |"
+)");
+  // clang-format on
+}